@@ -0,0 +1,800 @@
+#include "benchmark_suite.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include <monopp/mono_assembly.h>
+#include <monopp/mono_batch_invoker.h>
+#include <monopp/mono_binding.h>
+#include <monopp/mono_domain.h>
+#include <monopp/mono_field.h>
+#include <monopp/mono_field_invoker.h>
+#include <monopp/mono_field_set.h>
+#include <monopp/mono_gc_handle.h>
+#include <monopp/mono_jit.h>
+#include <monopp/mono_list.h>
+#include <monopp/mono_method_invoker.h>
+#include <monopp/mono_object.h>
+#include <monopp/mono_property.h>
+#include <monopp/mono_property_invoker.h>
+#include <monopp/mono_thread.h>
+#include <monopp/mono_type.h>
+#include <suitepp/suite.hpp>
+
+namespace benchmark
+{
+
+namespace
+{
+template <typename F>
+auto measure(const std::string& name, size_t iterations, F&& f) -> double
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	for(size_t i = 0; i < iterations; ++i)
+	{
+		f(i);
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	auto total = std::chrono::duration<double, std::nano>(end - start).count();
+	auto per_iteration = total / double(iterations);
+	std::cout << name << " : " << per_iteration << " ns/iter" << std::endl;
+	return per_iteration;
+}
+} // namespace
+
+void test_suite()
+{
+	mono::mono_domain domain("benchmark_domain");
+	mono::mono_domain::set_current_domain(domain);
+
+	constexpr size_t iterations = 1000000;
+
+	TEST_CASE("benchmark method invoker")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+
+			auto runtime_invoker = mono::make_method_invoker<int(int)>(type, "Function1");
+			auto thunk_invoker = mono::make_thunk_invoker<int(int)>(type, "Function1");
+
+			int sink = 0;
+			measure("mono_runtime_invoke Function1(int)", iterations,
+					[&](size_t i) { sink += runtime_invoker(int(i)); });
+			measure("unmanaged thunk Function1(int)", iterations,
+					[&](size_t i) { sink += thunk_invoker(int(i)); });
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark method resolution")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+
+			constexpr size_t resolutions = 100000;
+			measure("uncached resolve Function1(int)", resolutions,
+					[&](size_t) { type.get_method("Function1(int)"); });
+			measure("cached make_method_invoker<int(int)> Function1", resolutions,
+					[&](size_t) { mono::make_method_invoker<int(int)>(type, "Function1"); });
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark signature check")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			auto method = type.get_method("Function4", 1);
+
+			bool sink = true;
+			measure("has_compatible_signature<std::string(std::string)>", iterations,
+					[&](size_t) { sink &= mono::has_compatible_signature<std::string(std::string)>(method); });
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark worker thread fan out")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			auto method = mono::make_thunk_invoker<int(int)>(type, "Function1");
+
+			auto workers = std::max(1u, std::thread::hardware_concurrency());
+			auto per_worker = iterations / workers;
+			auto start = std::chrono::high_resolution_clock::now();
+			std::vector<std::thread> threads;
+			for(unsigned w = 0; w < workers; ++w)
+			{
+				threads.emplace_back(
+					[&]()
+					{
+						int sink = 0;
+						for(size_t i = 0; i < per_worker; ++i)
+						{
+							sink += method(int(i));
+						}
+						mono::ignore(sink);
+					});
+			}
+			for(auto& thread : threads)
+			{
+				thread.join();
+			}
+			auto end = std::chrono::high_resolution_clock::now();
+			auto total = std::chrono::duration<double, std::nano>(end - start).count();
+
+			auto stats = mono::get_thread_attach_stats();
+			std::cout << "fan out " << workers << " workers : " << total / double(per_worker * workers)
+					  << " ns/call" << std::endl;
+			std::cout << "thread attach : " << stats.average_attach_ns() << " ns avg, " << stats.max_attach_ns
+					  << " ns max over " << stats.attached << " attaches" << std::endl;
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark domain type resolution")
+	{
+		auto expression = [&]()
+		{
+			// framework assemblies and facades next to mscorlib
+			auto corlib_path = mono::get_core_assembly_path();
+			auto dir = corlib_path.substr(0, corlib_path.find_last_of("/\\") + 1);
+			const std::vector<std::string> names = {
+				"System", "System.Core", "System.Xml", "System.Xml.Linq", "System.Data", "System.Numerics",
+				"System.Drawing", "System.Net.Http", "System.Runtime.Serialization", "System.Configuration",
+				"System.ComponentModel.DataAnnotations", "System.Transactions", "System.IO.Compression",
+				"System.Security", "System.ServiceModel", "System.Web", "Mono.Security", "Mono.Posix",
+				"Mono.Cecil", "Microsoft.CSharp", "Facades/System.Runtime", "Facades/System.Collections",
+				"Facades/System.Linq", "Facades/System.Threading", "Facades/System.Threading.Tasks",
+				"Facades/System.IO", "Facades/System.Reflection", "Facades/System.Text.Encoding",
+				"Facades/System.Globalization", "Facades/System.Diagnostics.Debug",
+				"Facades/System.Runtime.Extensions", "Facades/System.Runtime.InteropServices",
+				"Facades/System.ObjectModel", "Facades/System.Collections.Concurrent",
+				"Facades/System.Linq.Expressions", "Facades/System.Dynamic.Runtime",
+				"Facades/System.Resources.ResourceManager", "Facades/System.Reflection.Extensions",
+				"Facades/System.Reflection.Primitives", "Facades/System.Text.RegularExpressions",
+				"Facades/System.Xml.ReaderWriter", "Facades/System.Xml.XDocument",
+				"Facades/System.Runtime.Numerics", "Facades/System.Threading.Timer",
+				"Facades/System.Net.Primitives", "Facades/System.ComponentModel",
+				"Facades/System.Diagnostics.Tools", "Facades/System.Linq.Queryable",
+				"Facades/System.Linq.Parallel", "Facades/System.Runtime.Serialization.Primitives",
+				"Facades/System.Console", "Facades/System.IO.FileSystem", "Facades/System.Collections.NonGeneric",
+				"Facades/System.Collections.Specialized", "Facades/System.Diagnostics.Process",
+				"Facades/System.Security.Cryptography.Algorithms"};
+
+			mono::mono_domain many_domain("many_assemblies_domain");
+			mono::mono_domain::set_current_domain(many_domain);
+			std::vector<mono::mono_assembly> loaded;
+			for(const auto& name : names)
+			{
+				try
+				{
+					loaded.emplace_back(many_domain.get_assembly(dir + name + ".dll"));
+				}
+				catch(const mono::mono_exception&)
+				{
+				}
+			}
+			loaded.emplace_back(many_domain.get_assembly(DATA_DIR "tests_managed.dll"));
+			std::cout << "loaded assemblies : " << loaded.size() << std::endl;
+
+			size_t sink = 0;
+			measure("scan all assemblies for a missing type", iterations / 100,
+					[&](size_t)
+					{
+						for(const auto& assembly : loaded)
+						{
+							sink += assembly.get_type("Serializer", "MissingType").valid();
+						}
+					});
+			measure("domain get_type missing type (negative cache)", iterations,
+					[&](size_t) { sink += many_domain.get_type("Serializer", "MissingType").valid(); });
+			measure("domain get_type Tests.MonoppTest (positive cache)", iterations,
+					[&](size_t) { sink += many_domain.get_type("Tests", "MonoppTest").valid(); });
+			mono::ignore(sink);
+
+			mono::mono_domain::set_current_domain(domain);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark nested type lookup")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			size_t sink = 0;
+			measure("get_type Tests.Nested.TestClassNested1.TestClassNested2", iterations / 10,
+					[&](size_t)
+					{
+						sink += assembly.get_type("Tests.Nested.TestClassNested1.TestClassNested2").valid();
+					});
+
+			auto stats = assembly.get_type_index_stats();
+			std::cout << "type index : " << stats.size << " names, " << stats.hits << " hits, " << stats.misses
+					  << " misses" << std::endl;
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark type name hashing")
+	{
+		auto expression = [&]()
+		{
+			// the byte at a time crc it replaced
+			auto bytewise = [](const std::string& str)
+			{
+				const auto& t = mono::detail::crc64_tables<>::value.t;
+				std::uint64_t crc = 0;
+				for(auto c : str)
+				{
+					crc = (crc >> 8) ^ t[0][(crc ^ std::uint8_t(c)) & 0xff];
+				}
+				return crc;
+			};
+
+			const std::vector<std::string> names = {
+				"Vector3", "Tests.MonoppTest", "System.Collections.Generic.List`1",
+				"System.Collections.Generic.Dictionary`2[[System.String],[System.Int32]]"};
+
+			size_t sink = 0;
+			for(const auto& name : names)
+			{
+				auto label = " (" + std::to_string(name.size()) + " chars)";
+				measure("crc64 bytewise" + label, iterations, [&](size_t) { sink += bytewise(name); });
+				measure("crc64 slicing-by-8" + label, iterations,
+						[&](size_t) { sink += mono::mono_type::get_hash(name); });
+			}
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark cold metadata")
+	{
+		auto expression = [&]()
+		{
+			std::vector<MonoClass*> classes;
+			{
+				for(const auto& type : mono::mono_assembly::get_corlib().get_types())
+				{
+					classes.emplace_back(type.get_internal_ptr());
+				}
+			}
+
+			auto cold_start = [&](const std::string& name, auto&& use)
+			{
+				// no wrappers are alive here, so dropping the records is safe
+				mono::reset_type_cache();
+				mono::reset_method_cache();
+				measure(name + " over " + std::to_string(classes.size()) + " corlib types", classes.size(),
+						[&](size_t i) { use(mono::mono_type(classes[i])); });
+			};
+
+			size_t sink = 0;
+			cold_start("cold wrap only", [&](const mono::mono_type& type) { sink += type.valid(); });
+			cold_start("cold wrap + name", [&](const mono::mono_type& type) { sink += type.get_name().size(); });
+			cold_start("cold wrap + all attributes",
+					   [&](const mono::mono_type& type)
+					   {
+						   sink += type.get_hash() + type.get_namespace().size() + type.get_fullname().size() +
+								   type.get_sizeof() + type.get_alignof() + size_t(type.get_rank()) +
+								   type.is_valuetype() + type.is_enum() + type.is_array();
+					   });
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark wrapper copies")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			auto obj = type.new_instance();
+
+			std::vector<mono::mono_object> objects(1000);
+			measure("copy mono_object x1000", iterations / 1000,
+					[&](size_t) { std::fill(objects.begin(), objects.end(), obj); });
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark metadata cache contention")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto cls = assembly.get_type("Tests", "MonoppTest").get_internal_ptr();
+
+			auto lookup = [cls](size_t count)
+			{
+				size_t sink = 0;
+				for(size_t i = 0; i < count; ++i)
+				{
+					sink += mono::mono_type(cls).get_name().size();
+				}
+				return sink;
+			};
+
+			measure("mono_type meta lookup, 1 thread", iterations, [&](size_t) { lookup(1); });
+
+			auto workers = std::max(1u, std::thread::hardware_concurrency());
+			auto per_worker = iterations / workers;
+			auto start = std::chrono::high_resolution_clock::now();
+			std::vector<std::thread> threads;
+			for(unsigned w = 0; w < workers; ++w)
+			{
+				threads.emplace_back(
+					[&]()
+					{
+						mono::mono_thread_scope scope;
+						mono::ignore(lookup(per_worker));
+					});
+			}
+			for(auto& thread : threads)
+			{
+				thread.join();
+			}
+			auto end = std::chrono::high_resolution_clock::now();
+			auto total = std::chrono::duration<double, std::nano>(end - start).count();
+			std::cout << "mono_type meta lookup, " << workers << " threads : "
+					  << total / double(per_worker * workers) << " ns/iter" << std::endl;
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark inheritance queries")
+	{
+		auto expression = [&]()
+		{
+			auto corlib = mono::mono_assembly::get_corlib();
+			auto types = corlib.get_types();
+			auto exception = corlib.get_type("System", "Exception");
+			auto disposable = corlib.get_type("System", "IDisposable");
+
+			constexpr size_t queries = 100;
+			size_t sink = 0;
+			measure("scan corlib for Exception subclasses", queries,
+					[&](size_t)
+					{
+						for(const auto& type : types)
+						{
+							sink += type.is_derived_from(exception) ? 1 : 0;
+						}
+					});
+			measure("indexed corlib Exception subclasses", queries,
+					[&](size_t) { sink += corlib.get_types_derived_from(exception).size(); });
+			measure("indexed corlib IDisposable implementors", queries,
+					[&](size_t) { sink += corlib.get_types_implementing(disposable).size(); });
+
+			auto argument = corlib.get_type("System", "ArgumentNullException");
+			measure("mono_class_is_subclass_of hot pair", iterations,
+					[&](size_t)
+					{
+						sink += mono_class_is_subclass_of(argument.get_internal_ptr(),
+														  disposable.get_internal_ptr(), true);
+					});
+			measure("cached is_derived_from hot pair", iterations,
+					[&](size_t) { sink += argument.is_derived_from(disposable) ? 1 : 0; });
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark member tables")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+
+			constexpr size_t queries = 10000;
+			size_t sink = 0;
+			measure("re-lookup every member by name", queries / 10,
+					[&](size_t)
+					{
+						for(const auto& field : type.get_fields())
+						{
+							sink += type.get_field(field.get_name()).get_name().size();
+						}
+						for(const auto& method : type.get_methods())
+						{
+							auto argc = int(method.get_param_types().size());
+							sink += type.get_method(method.get_name(), argc).get_name().size();
+						}
+					});
+			measure("get_fields + get_properties + get_methods", queries,
+					[&](size_t)
+					{
+						sink += type.get_fields().size() + type.get_properties().size() +
+								type.get_methods().size();
+					});
+			measure("get_methods(true) over the hierarchy", queries,
+					[&](size_t) { sink += type.get_methods(true).size(); });
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark attribute scan")
+	{
+		auto expression = [&]()
+		{
+			auto corlib = mono::mono_assembly::get_corlib();
+			auto types = corlib.get_types();
+			auto obsolete = corlib.get_type("System", "ObsoleteAttribute");
+
+			size_t sink = 0;
+			measure("instantiate attributes of " + std::to_string(types.size()) + " corlib types", types.size(),
+					[&](size_t i) { sink += types[i].get_attributes().size(); });
+			measure("has_attribute(ObsoleteAttribute) over corlib types", types.size(),
+					[&](size_t i) { sink += types[i].has_attribute(obsolete) ? 1 : 0; });
+			measure("has_attribute(ObsoleteAttribute), cached", iterations,
+					[&](size_t i) { sink += types[i % types.size()].has_attribute(obsolete) ? 1 : 0; });
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark enum values")
+	{
+		auto expression = [&]()
+		{
+			auto corlib = mono::mono_assembly::get_corlib();
+			auto type_code = corlib.get_type("System", "TypeCode");
+
+			constexpr size_t queries = 100000;
+			size_t sink = 0;
+			measure("get_enum_values<int32_t> TypeCode", queries,
+					[&](size_t) { sink += type_code.get_enum_values<int32_t>().size(); });
+			measure("get_enum_name TypeCode", queries,
+					[&](size_t i) { sink += type_code.get_enum_name(int32_t(i % 19)) != nullptr; });
+			int32_t value = 0;
+			measure("get_enum_value TypeCode", queries,
+					[&](size_t) { sink += type_code.get_enum_value("String", value) ? size_t(value) : 0; });
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark metadata snapshot startup")
+	{
+		auto expression = [&]()
+		{
+			auto corlib_path = mono::get_core_assembly_path();
+			auto dir = corlib_path.substr(0, corlib_path.find_last_of("/\\") + 1);
+			std::vector<mono::mono_assembly> assemblies = {mono::mono_assembly::get_corlib()};
+			for(const auto& name : {"System", "System.Core", "System.Xml", "System.Data"})
+			{
+				try
+				{
+					assemblies.emplace_back(domain.get_assembly(dir + name + ".dll"));
+				}
+				catch(const mono::mono_exception&)
+				{
+				}
+			}
+
+			// classes whose member tables a start up rebuilds
+			std::vector<MonoClass*> classes;
+			for(const auto& name : {"System.String", "System.Convert", "System.Math", "System.Array"})
+			{
+				classes.push_back(mono::mono_assembly::get_corlib().get_type(name).get_internal_ptr());
+			}
+
+			// a dotted lookup builds the index of every assembly it touches
+			size_t sink = 0;
+			auto start_up = [&](size_t)
+			{
+				mono::reset_assembly_cache();
+				mono::reset_type_cache();
+				for(const auto& assembly : assemblies)
+				{
+					sink += assembly.get_type("Serializer.MissingType").valid();
+				}
+				for(auto cls : classes)
+				{
+					mono::mono_type type(cls);
+					sink += type.get_methods().size() + type.get_fields().size();
+					sink += type.get_method("ToString", 0).valid();
+				}
+			};
+
+			constexpr size_t starts = 20;
+			const std::string path = "benchmark_metadata_snapshot.bin";
+			measure("cold type index start over " + std::to_string(assemblies.size()) + " assemblies", starts,
+					start_up);
+			mono::mono_assembly::save_metadata_snapshot(path, assemblies);
+			measure("snapshot load + warm type index start", starts,
+					[&](size_t i)
+					{
+						sink += mono::mono_assembly::load_metadata_snapshot(path);
+						start_up(i);
+					});
+			std::remove(path.c_str());
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark generated bindings")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+
+			// what a generated wrapper holds after bind(): an unchecked thunk slot,
+			// resolved by name here since there is no generated token to use
+			mono::mono_binding_context context(assembly, "");
+			auto slot =
+				mono::make_thunk_invoker<int(int)>(context.get_method(type, 0, "Function1(int)"), false);
+
+			constexpr size_t calls = 100000;
+			int sink = 0;
+			measure("lookup + checked invoker per call", calls,
+					[&](size_t i)
+					{ sink += mono::make_method_invoker<int(int)>(type, "Function1")(int(i)); });
+			measure("bound slot call", calls, [&](size_t i) { sink += slot(int(i)); });
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark field access")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+			auto obj = type.new_instance();
+			auto number = mono::make_field_invoker<int32_t>(type, "number");
+			auto text = mono::make_field_invoker<mono::mono_object>(type, "text");
+			auto raw_number = number.get_internal_ptr();
+			auto raw_obj = obj.get_internal_ptr();
+
+			int32_t sink = 0;
+			measure("mono_field_get_value int", iterations,
+					[&](size_t)
+					{
+						int32_t value = 0;
+						mono_field_get_value(raw_obj, raw_number, &value);
+						sink += value;
+					});
+			measure("direct get_value int", iterations, [&](size_t) { sink += number.get_value(obj); });
+			measure("mono_field_set_value int", iterations,
+					[&](size_t i)
+					{
+						auto value = int32_t(i);
+						mono_field_set_value(raw_obj, raw_number, &value);
+					});
+			measure("direct set_value int", iterations, [&](size_t i) { number.set_value(obj, int32_t(i)); });
+
+			auto value = text.get_value(obj);
+			measure("direct set_value reference (write barrier)", iterations,
+					[&](size_t) { text.set_value(obj, value); });
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark static field access")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+			auto shared = mono::make_field_invoker<int32_t>(type, "shared");
+			auto raw_field = shared.get_internal_ptr();
+			auto vtable = mono_class_vtable(mono_domain_get(), type.get_internal_ptr());
+
+			int32_t sink = 0;
+			measure("mono_field_static_get_value int", iterations,
+					[&](size_t)
+					{
+						int32_t value = 0;
+						mono_field_static_get_value(vtable, raw_field, &value);
+						sink += value;
+					});
+			measure("direct static get_value int", iterations, [&](size_t) { sink += shared.get_value(); });
+			measure("direct static set_value int", iterations, [&](size_t i) { shared.set_value(int32_t(i)); });
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark field set snapshot")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+			auto obj = type.new_instance();
+			const std::vector<std::string> names = {"number", "position", "text", "reference", "tag"};
+
+			std::vector<MonoClassField*> raw_fields;
+			for(const auto& name : names)
+			{
+				raw_fields.push_back(mono::mono_field(type, name).get_internal_ptr());
+			}
+			mono::mono_field_set fields(type, names);
+			std::vector<std::uint64_t> buffer((fields.get_buffer_size() + 7) / 8);
+			const auto& entries = fields.get_entries();
+
+			constexpr size_t objects = 100000;
+			measure("mono_field_get_value per field x" + std::to_string(names.size()), objects,
+					[&](size_t)
+					{
+						auto out = reinterpret_cast<char*>(buffer.data());
+						for(size_t i = 0; i < raw_fields.size(); ++i)
+						{
+							mono_field_get_value(obj.get_internal_ptr(), raw_fields[i],
+												 out + entries[i].buffer_offset);
+						}
+					});
+			// references are held as gc handles, so a snapshot is freed by its restore
+			measure("field set snapshot + restore x" + std::to_string(names.size()), objects,
+					[&](size_t)
+					{
+						fields.snapshot(obj, buffer.data());
+						fields.restore(obj, buffer.data());
+					});
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark field gather")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+			std::vector<mono::mono_object> objects;
+			for(size_t i = 0; i < 10000; ++i)
+			{
+				objects.emplace_back(type.new_instance());
+			}
+			std::vector<mono::mono_scoped_gc_handle> pins(objects.size());
+			for(size_t i = 0; i < objects.size(); ++i)
+			{
+				pins[i].lock(objects[i]);
+			}
+
+			struct vec2
+			{
+				float x;
+				float y;
+			};
+			auto position = mono::make_field_invoker<vec2>(type, "position");
+			std::vector<vec2> positions(objects.size());
+
+			constexpr size_t frames = 100;
+			measure("get_value per object x" + std::to_string(objects.size()), frames,
+					[&](size_t)
+					{
+						for(size_t i = 0; i < objects.size(); ++i)
+						{
+							positions[i] = position.get_value(objects[i]);
+						}
+					});
+			measure("gather x" + std::to_string(objects.size()), frames,
+					[&](size_t) { position.gather(objects, positions.data()); });
+			measure("scatter x" + std::to_string(objects.size()), frames,
+					[&](size_t) { position.scatter(objects, positions.data()); });
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark property access")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+			auto obj = type.new_instance();
+			auto property = type.get_property("VirtualAuto");
+			auto cached = mono::make_property_invoker<int>(property);
+			auto automatic = mono::make_property_invoker<int>(type.get_property("Auto"));
+
+			int sink = 0;
+			measure("resolve getter per call", iterations,
+					[&](size_t) { sink += mono::make_method_invoker<int()>(property.get_get_method())(obj); });
+			measure("cached getter thunk", iterations, [&](size_t) { sink += cached.get_value(obj); });
+			measure("auto-property backing field", iterations, [&](size_t) { sink += automatic.get_value(obj); });
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark list access")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+			auto obj = type.new_instance();
+			auto field = mono::make_field_invoker<mono::mono_object>(type, "numbers");
+			mono::mono_list<int32_t> numbers(field.get_value(obj));
+			auto item = mono::make_property_invoker<int32_t>(numbers.get_type(), "Item");
+
+			int32_t sink = 0;
+			measure("Item indexer per element", iterations,
+					[&](size_t i) { sink += item.get_value_with_args(numbers, int(i % 3)); });
+			measure("direct get per element", iterations, [&](size_t i) { sink += numbers.get(i % 3); });
+			measure("size", iterations, [&](size_t) { sink += int32_t(numbers.size()); });
+			measure("to_vector", iterations / 10, [&](size_t) { sink += numbers.to_vector()[0]; });
+
+			std::vector<int32_t> values(100000, 1);
+			auto add = mono::make_method_invoker<void(int32_t)>(numbers.get_type(), "Add");
+			measure("Add 100k elements", 10,
+					[&](size_t)
+					{
+						numbers.clear();
+						for(auto value : values)
+						{
+							add(numbers, value);
+						}
+					});
+			measure("add_range 100k elements", 10,
+					[&](size_t)
+					{
+						numbers.clear();
+						numbers.add_range(values);
+					});
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("benchmark virtual dispatch")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto base_type = assembly.get_type("Tests", "DispatchBase");
+			auto derived1 = assembly.get_type("Tests", "DispatchDerived1");
+			auto derived2 = assembly.get_type("Tests", "DispatchDerived2");
+
+			std::vector<mono::mono_object> objects;
+			for(size_t i = 0; i < 1000; ++i)
+			{
+				objects.emplace_back(i % 2 ? derived1.new_instance() : derived2.new_instance());
+			}
+			std::vector<mono::mono_scoped_gc_handle> pins(objects.size());
+			for(size_t i = 0; i < objects.size(); ++i)
+			{
+				pins[i].lock(objects[i]);
+			}
+
+			auto invoker = mono::make_thunk_invoker<int(int)>(base_type, "Update");
+
+			int sink = 0;
+			measure("cached virtual thunk Update(int)", iterations,
+					[&](size_t i) { sink += invoker(objects[i % objects.size()], int(i)); });
+
+			std::cout << "dispatch cache hit rate : " << invoker.get_dispatch_stats().hit_rate() << std::endl;
+
+			auto batch_invoker = mono::make_batch_invoker(invoker);
+			measure("batched virtual thunk Update(int) x1000", iterations / objects.size(),
+					[&](size_t i) { sink += batch_invoker(objects, int(i)).values.front(); });
+			mono::ignore(sink);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+}
+} // namespace benchmark
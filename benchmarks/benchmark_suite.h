@@ -0,0 +1,6 @@
+#pragma once
+
+namespace benchmark
+{
+void test_suite();
+}
@@ -0,0 +1,17 @@
+#include "benchmark_suite.h"
+
+#include <monopp/mono_jit.h>
+
+int main()
+{
+	if(!mono::init())
+	{
+		return 1;
+	}
+
+	benchmark::test_suite();
+
+	mono::shutdown();
+
+	return 0;
+}
@@ -1,15 +1,26 @@
 #include "mono_assembly.h"
 #include "mono_domain.h"
 #include "mono_exception.h"
+#include "mono_field.h"
 
+#include "mono_meta_cache.h"
+#include "mono_method.h"
 #include "mono_string.h"
 #include "mono_type.h"
+
+#include <algorithm>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 BEGIN_MONO_INCLUDE
 #include <mono/metadata/appdomain.h>
 #include <mono/metadata/assembly.h>
+#include <mono/metadata/attrdefs.h>
 #include <mono/metadata/image.h>
 #include <mono/metadata/tokentype.h>
 END_MONO_INCLUDE
@@ -68,87 +79,459 @@ auto read_stream_into_container(std::basic_istream<CharT, Traits>& in, Container
 	return in.good() || in.eof();
 }
 
-namespace
+using type_name_tokens = std::unordered_map<std::string, uint32_t>;
+
+// Maps the full name of every type defined in an image to its typedef
+// token. Nested types use '.' as separator ('+' is normalized on lookup).
+struct type_name_index
+{
+	// shared with the snapshot it may come from
+	lazy_value<std::shared_ptr<const type_name_tokens>> tokens;
+	std::atomic<std::uint64_t> hits{0};
+	std::atomic<std::uint64_t> misses{0};
+	std::atomic<bool> from_snapshot{false};
+};
+
+// The metadata of one image read from a snapshot file.
+struct snapshot_entry
+{
+	uint32_t typedef_rows = 0;
+	std::shared_ptr<const type_name_tokens> tokens;
+	// keyed by typedef token
+	std::unordered_map<uint32_t, detail::snapshot_members> members;
+};
+
+constexpr char snapshot_magic[8] = {'M', 'O', 'N', 'O', 'P', 'P', 'T', 'I'};
+constexpr uint32_t snapshot_version = 2;
+
+auto get_snapshot_mutex() -> std::mutex&
 {
-static auto split_tokens(const std::string& s) -> std::vector<std::string>
-{
-    // allow both '.' and '+' as separators in input
-    std::vector<std::string> out;
-    size_t start = 0;
-    while (start < s.size())
-    {
-        size_t sep = s.find_first_of(".+", start);
-        if (sep == std::string::npos)
-        {
-            out.push_back(s.substr(start));
-            break;
-        }
-        out.push_back(s.substr(start, sep - start));
-        start = sep + 1;
-    }
-    return out;
-}
-
-static MonoClass* find_direct_nested(MonoClass* outer, const std::string& nested_name)
-{
-    if (!outer) return nullptr;
-    mono_class_init(outer);
-
-    void* iter = nullptr;
-    while (MonoClass* nested = mono_class_get_nested_types(outer, &iter))
-    {
-        const char* n = mono_class_get_name(nested);
-        if (n && nested_name == n)
-            return nested;
-    }
-    return nullptr;
-}
-
-static MonoClass* class_from_fullname_guessing(MonoImage* image, const std::string& full)
-{
-    if (!image || full.empty()) return nullptr;
-
-    auto parts = split_tokens(full);
-    if (parts.empty()) return nullptr;
-
-    // Try all possible splits:
-    // namespace = parts[0..outer_idx-1], outer = parts[outer_idx], nested = parts[outer_idx+1..]
-    for (size_t outer_idx = 0; outer_idx < parts.size(); ++outer_idx)
-    {
-        // Build namespace candidate
-        std::string ns;
-        for (size_t i = 0; i < outer_idx; ++i)
-        {
-            if (i) ns.push_back('.');
-            ns.append(parts[i].data(), parts[i].size());
-        }
-
-        std::string outer(parts[outer_idx].data(), parts[outer_idx].size());
-        if (outer.empty())
-            continue;
-
-        MonoClass* klass = mono_class_from_name(image, ns.c_str(), outer.c_str());
-        if (!klass)
-            continue;
-
-        bool ok = true;
-        for (size_t ni = outer_idx + 1; ni < parts.size(); ++ni)
-        {
-            klass = find_direct_nested(klass, parts[ni]);
-            if (!klass)
-            {
-                ok = false;
-                break;
-            }
-        }
-
-        if (ok)
-            return klass;
-    }
-
-    return nullptr;
+	static std::mutex mutex;
+	return mutex;
+}
+
+using snapshot_entries = std::unordered_map<std::string, std::shared_ptr<const snapshot_entry>>;
+
+// keyed by image MVID, kept across domains
+auto get_snapshot_entries() -> snapshot_entries&
+{
+	static snapshot_entries entries;
+	return entries;
+}
+
+// lets lookups skip the MVID and the lock while no snapshot is loaded
+std::atomic<bool> snapshot_loaded{false};
+
+// A class defined by a TypeDef row, not a generic instance or an array of one.
+auto is_type_definition(MonoClass* cls, MonoImage* image, uint32_t token) -> bool
+{
+	return (token & 0xff000000) == MONO_TOKEN_TYPE_DEF && mono_class_get(image, token) == cls;
+}
+
+void write_u32(std::string& out, uint32_t value)
+{
+	for(int i = 0; i < 4; ++i)
+	{
+		out.push_back(char((value >> (i * 8)) & 0xff));
+	}
+}
+
+void write_string(std::string& out, const std::string& str)
+{
+	write_u32(out, uint32_t(str.size()));
+	out += str;
+}
+
+auto read_u32(const char*& cursor, const char* end, uint32_t& value) -> bool
+{
+	if(end - cursor < 4)
+	{
+		return false;
+	}
+	value = 0;
+	for(int i = 0; i < 4; ++i)
+	{
+		value |= uint32_t(uint8_t(cursor[i])) << (i * 8);
+	}
+	cursor += 4;
+	return true;
+}
+
+auto read_string(const char*& cursor, const char* end, std::string& str) -> bool
+{
+	uint32_t size = 0;
+	if(!read_u32(cursor, end, size) || uint32_t(end - cursor) < size)
+	{
+		return false;
+	}
+	str.assign(cursor, size);
+	cursor += size;
+	return true;
+}
+
+void write_members(std::string& out, MonoClass* cls)
+{
+	mono_type type(cls);
+	const auto& fields = type.get_fields(false);
+	write_u32(out, uint32_t(fields.size()));
+	for(const auto& field : fields)
+	{
+		write_u32(out, mono_class_get_field_token(field.get_internal_ptr()));
+	}
+
+	const auto& methods = type.get_methods(false);
+	write_u32(out, uint32_t(methods.size()));
+	for(const auto& method : methods)
+	{
+		auto handle = method.get_internal_ptr();
+		write_u32(out, mono_method_get_token(handle));
+		write_u32(out, mono_signature_get_param_count(mono_method_signature(handle)));
+		write_string(out, mono_method_get_name(handle));
+	}
+}
+
+auto has_token_type(uint32_t token, uint32_t type) -> bool
+{
+	return (token & 0xff000000) == type && (token & 0x00ffffff) != 0;
+}
+
+auto parse_members(const char*& cursor, const char* end, detail::snapshot_members& members) -> bool
+{
+	uint32_t count = 0;
+	if(!read_u32(cursor, end, count))
+	{
+		return false;
+	}
+	members.fields.resize(count);
+	for(auto& token : members.fields)
+	{
+		if(!read_u32(cursor, end, token) || !has_token_type(token, MONO_TOKEN_FIELD_DEF))
+		{
+			return false;
+		}
+	}
+
+	if(!read_u32(cursor, end, count))
+	{
+		return false;
+	}
+	members.methods.resize(count);
+	for(auto& method : members.methods)
+	{
+		uint32_t param_count = 0;
+		if(!read_u32(cursor, end, method.token) || !has_token_type(method.token, MONO_TOKEN_METHOD_DEF) ||
+		   !read_u32(cursor, end, param_count) || !read_string(cursor, end, method.name))
+		{
+			return false;
+		}
+		method.param_count = int(param_count);
+	}
+	return true;
+}
+
+auto parse_snapshot(const std::vector<char>& buffer, snapshot_entries& entries) -> bool
+{
+	auto cursor = buffer.data();
+	auto end = cursor + buffer.size();
+	if(buffer.size() < sizeof(snapshot_magic) ||
+	   !std::equal(std::begin(snapshot_magic), std::end(snapshot_magic), cursor))
+	{
+		return false;
+	}
+	cursor += sizeof(snapshot_magic);
+
+	uint32_t version = 0;
+	uint32_t images = 0;
+	if(!read_u32(cursor, end, version) || version != snapshot_version || !read_u32(cursor, end, images))
+	{
+		return false;
+	}
+
+	for(uint32_t i = 0; i < images; ++i)
+	{
+		std::string guid;
+		auto entry = std::make_shared<snapshot_entry>();
+		uint32_t count = 0;
+		if(!read_string(cursor, end, guid) || !read_u32(cursor, end, entry->typedef_rows) ||
+		   !read_u32(cursor, end, count))
+		{
+			return false;
+		}
+
+		auto is_typedef = [&entry](uint32_t token)
+		{
+			return has_token_type(token, MONO_TOKEN_TYPE_DEF) && (token & 0x00ffffff) <= entry->typedef_rows;
+		};
+
+		auto tokens = std::make_shared<type_name_tokens>();
+		tokens->reserve(count);
+		for(uint32_t j = 0; j < count; ++j)
+		{
+			uint32_t token = 0;
+			std::string name;
+			if(!read_u32(cursor, end, token) || !read_string(cursor, end, name) || !is_typedef(token))
+			{
+				return false;
+			}
+			tokens->emplace(std::move(name), token);
+		}
+		entry->tokens = std::move(tokens);
+
+		if(!read_u32(cursor, end, count))
+		{
+			return false;
+		}
+		for(uint32_t j = 0; j < count; ++j)
+		{
+			uint32_t token = 0;
+			if(!read_u32(cursor, end, token) || !is_typedef(token) ||
+			   !parse_members(cursor, end, entry->members[token]))
+			{
+				return false;
+			}
+		}
+		entries[guid] = std::move(entry);
+	}
+	return cursor == end;
+}
+
+// The snapshot of the image if there is one with the same MVID and TypeDef rows.
+auto find_snapshot_entry(MonoImage* image) -> std::shared_ptr<const snapshot_entry>
+{
+	auto guid = mono_image_get_guid(image);
+	if(!guid)
+	{
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(get_snapshot_mutex());
+	const auto& entries = get_snapshot_entries();
+	auto it = entries.find(guid);
+	if(it == entries.end() ||
+	   it->second->typedef_rows != uint32_t(mono_image_get_table_rows(image, MONO_TABLE_TYPEDEF)))
+	{
+		return nullptr;
+	}
+	return it->second;
+}
+
+auto get_type_index_cache() -> mono_meta_cache<MonoImage*, type_name_index>&
+{
+	static mono_meta_cache<MonoImage*, type_name_index> type_index_cache;
+	return type_index_cache;
+}
+
+// One pass over the TypeDef and NestedClass tables, no classes are loaded.
+auto build_type_name_index(MonoImage* image) -> std::shared_ptr<const type_name_tokens>
+{
+	auto typedefs = mono_image_get_table_info(image, MONO_TABLE_TYPEDEF);
+	auto rows = size_t(mono_table_info_get_rows(typedefs));
+
+	std::vector<const char*> names(rows);
+	std::vector<const char*> namespaces(rows);
+	for(size_t i = 0; i < rows; ++i)
+	{
+		uint32_t cols[MONO_TYPEDEF_SIZE];
+		mono_metadata_decode_row(typedefs, int(i), cols, MONO_TYPEDEF_SIZE);
+		names[i] = mono_metadata_string_heap(image, cols[MONO_TYPEDEF_NAME]);
+		namespaces[i] = mono_metadata_string_heap(image, cols[MONO_TYPEDEF_NAMESPACE]);
+	}
+
+	// 1-based typedef row of the enclosing type, 0 if not nested
+	std::vector<uint32_t> enclosing(rows, 0);
+	auto nested = mono_image_get_table_info(image, MONO_TABLE_NESTEDCLASS);
+	auto nested_rows = mono_table_info_get_rows(nested);
+	for(int i = 0; i < nested_rows; ++i)
+	{
+		uint32_t cols[MONO_NESTED_CLASS_SIZE];
+		mono_metadata_decode_row(nested, i, cols, MONO_NESTED_CLASS_SIZE);
+		if(cols[MONO_NESTED_CLASS_NESTED] > 0 && cols[MONO_NESTED_CLASS_NESTED] <= rows)
+		{
+			enclosing[cols[MONO_NESTED_CLASS_NESTED] - 1] = cols[MONO_NESTED_CLASS_ENCLOSING];
+		}
+	}
+
+	std::vector<std::string> fullnames(rows);
+	std::vector<bool> built(rows, false);
+	std::function<const std::string&(size_t)> fullname_of = [&](size_t i) -> const std::string&
+	{
+		if(!built[i])
+		{
+			built[i] = true;
+			auto outer = enclosing[i];
+			if(outer > 0 && outer <= rows && outer - 1 != i)
+			{
+				fullnames[i] = fullname_of(outer - 1) + "." + names[i];
+			}
+			else if(namespaces[i] && *namespaces[i])
+			{
+				fullnames[i] = std::string(namespaces[i]) + "." + names[i];
+			}
+			else
+			{
+				fullnames[i] = names[i];
+			}
+		}
+		return fullnames[i];
+	};
+
+	auto tokens = std::make_shared<type_name_tokens>();
+	tokens->reserve(rows);
+	for(size_t i = 0; i < rows; ++i)
+	{
+		tokens->emplace(fullname_of(i), uint32_t(MONO_TOKEN_TYPE_DEF | (i + 1)));
+	}
+	return tokens;
+}
+
+auto get_type_name_index(MonoImage* image) -> type_name_index&
+{
+	return get_type_index_cache().find_or_emplace(image);
+}
+
+auto get_type_name_tokens(MonoImage* image, type_name_index& index) -> const type_name_tokens&
+{
+	return *index.tokens.get(
+		[image, &index]()
+		{
+			if(auto entry = find_snapshot_entry(image))
+			{
+				index.from_snapshot = true;
+				return entry->tokens;
+			}
+			return build_type_name_index(image);
+		});
+}
+
+auto find_indexed_class(MonoImage* image, const std::string& full_name) -> MonoClass*
+{
+	if(!image || full_name.empty())
+	{
+		return nullptr;
+	}
+
+	auto& index = get_type_name_index(image);
+	const auto& tokens = get_type_name_tokens(image, index);
+
+	auto it = tokens.end();
+	if(full_name.find('+') == std::string::npos)
+	{
+		it = tokens.find(full_name);
+	}
+	else
+	{
+		auto normalized = full_name;
+		std::replace(normalized.begin(), normalized.end(), '+', '.');
+		it = tokens.find(normalized);
+	}
+
+	if(it == tokens.end())
+	{
+		index.misses++;
+		return nullptr;
+	}
+	index.hits++;
+	return mono_class_get(image, it->second);
+}
+
+// Subtype edges of the types defined in an image, built in one pass.
+struct inheritance_index
+{
+	// base class -> classes whose parent it is. Classes of other images
+	// appear as well when they sit between a local class and its ancestors,
+	// so that walking down from any base reaches every local subclass.
+	std::unordered_map<MonoClass*, std::vector<MonoClass*>> children;
+	// interface -> local classes implementing it, directly, through another
+	// interface or through a base class
+	std::unordered_map<MonoClass*, std::vector<MonoClass*>> implementors;
+	// interface -> local classes and interfaces listing it in their own declaration
+	std::unordered_map<MonoClass*, std::vector<MonoClass*>> declarers;
+	std::vector<MonoClass*> classes;
+};
+
+auto get_inheritance_cache() -> mono_meta_cache<MonoImage*, lazy_value<inheritance_index>>&
+{
+	static mono_meta_cache<MonoImage*, lazy_value<inheritance_index>> inheritance_cache;
+	return inheritance_cache;
+}
+
+auto is_interface_class(MonoClass* klass) -> bool
+{
+	return (mono_class_get_flags(klass) & MONO_TYPE_ATTR_INTERFACE) != 0;
+}
+
+void collect_interfaces(MonoClass* klass, std::unordered_set<MonoClass*>& interfaces)
+{
+	void* iter = nullptr;
+	while(auto iface = mono_class_get_interfaces(klass, &iter))
+	{
+		if(interfaces.insert(iface).second)
+		{
+			collect_interfaces(iface, interfaces);
+		}
+	}
+}
+
+auto build_inheritance_index(MonoImage* image) -> inheritance_index
+{
+	inheritance_index index;
+	auto rows = mono_image_get_table_rows(image, MONO_TABLE_TYPEDEF);
+	index.classes.reserve(size_t(rows));
+
+	std::unordered_set<MonoClass*> linked;
+	std::unordered_set<MonoClass*> interfaces;
+	for(int i = 1; i <= rows; ++i)
+	{
+		auto klass = mono_class_get(image, uint32_t(MONO_TOKEN_TYPE_DEF | i));
+		if(!klass)
+		{
+			continue;
+		}
+		index.classes.push_back(klass);
+
+		void* iter = nullptr;
+		while(auto iface = mono_class_get_interfaces(klass, &iter))
+		{
+			index.declarers[iface].push_back(klass);
+		}
+		if(is_interface_class(klass))
+		{
+			continue;
+		}
+
+		// link the class under its parent, and foreign ancestors under theirs
+		// up to the first local or already linked one
+		auto child = klass;
+		auto parent = mono_class_get_parent(child);
+		while(parent)
+		{
+			index.children[parent].push_back(child);
+			if(mono_class_get_image(parent) == image || !linked.insert(parent).second)
+			{
+				break;
+			}
+			child = parent;
+			parent = mono_class_get_parent(child);
+		}
+
+		interfaces.clear();
+		for(auto ancestor = klass; ancestor; ancestor = mono_class_get_parent(ancestor))
+		{
+			collect_interfaces(ancestor, interfaces);
+		}
+		for(auto iface : interfaces)
+		{
+			index.implementors[iface].push_back(klass);
+		}
+	}
+	return index;
+}
+
+auto get_inheritance_index(MonoImage* image) -> const inheritance_index&
+{
+	auto& index = get_inheritance_cache().find_or_emplace(image);
+	return index.get([image]() { return build_inheritance_index(image); });
 }
-} // namespace
 
 } // namespace
 
@@ -214,11 +597,11 @@ auto mono_assembly::get_type(const std::string& full_or_simple_name) const -> mo
 	if (full_or_simple_name.find('.') != std::string::npos ||
 		full_or_simple_name.find('+') != std::string::npos)
 	{
-		if (MonoClass* cls = class_from_fullname_guessing(image_, full_or_simple_name))
+		if (MonoClass* cls = find_indexed_class(image_, full_or_simple_name))
 			return mono_type(cls);
 	}
 
-	// Fallback: maybe it's a non-nested full name "Ns1.Ns2.Type"
+	// Fallback: types the image does not define itself (e.g. forwarded ones).
 	// Try splitting into (namespace, name) at last '.'
 	const size_t lastDot = full_or_simple_name.find_last_of('.');
 	if (lastDot != std::string::npos)
@@ -249,7 +632,7 @@ auto mono_assembly::get_type(const std::string& name_space, const std::string& n
 	}
     full += name;
 
-    if (MonoClass* cls = class_from_fullname_guessing(image_, full))
+    if (MonoClass* cls = find_indexed_class(image_, full))
 	{
 		return mono_type(cls);
 	}
@@ -257,6 +640,47 @@ auto mono_assembly::get_type(const std::string& name_space, const std::string& n
 	return {};
 }
 
+auto mono_assembly::get_type_by_token(uint32_t token) const -> mono_type
+{
+	if(!image_ || (token & 0xff000000) != MONO_TOKEN_TYPE_DEF)
+	{
+		return {};
+	}
+	return mono_type(mono_class_get(image_, token));
+}
+
+auto mono_assembly::get_method_by_token(uint32_t token) const -> mono_method
+{
+	if(!image_ || (token & 0xff000000) != MONO_TOKEN_METHOD_DEF)
+	{
+		return {};
+	}
+	return mono_method(mono_get_method(image_, token, nullptr));
+}
+
+auto mono_assembly::get_field_by_token(uint32_t token) const -> mono_field
+{
+	MonoClassField* field = nullptr;
+	if(image_ && (token & 0xff000000) == MONO_TOKEN_FIELD_DEF)
+	{
+		// fields are found through the class declaring them
+		auto type_row = mono_metadata_typedef_from_field(image_, token & 0x00ffffff);
+		auto klass = type_row ? mono_class_get(image_, MONO_TOKEN_TYPE_DEF | type_row) : nullptr;
+		field = klass ? mono_class_get_field(klass, token) : nullptr;
+	}
+	if(!field)
+	{
+		throw mono_exception("NATIVE::Could not get field with token : " + std::to_string(token));
+	}
+	return mono_field(field);
+}
+
+auto mono_assembly::get_mvid() const -> std::string
+{
+	auto guid = image_ ? mono_image_get_guid(image_) : nullptr;
+	return guid ? guid : "";
+}
+
 auto mono_assembly::get_corlib() -> mono_assembly
 {
 	return mono_assembly(mono_get_corlib());
@@ -282,21 +706,247 @@ std::vector<mono_type> mono_assembly::get_types() const
 
 auto mono_assembly::get_types_derived_from(const mono_type& base) const -> std::vector<mono_type>
 {
-	auto types = get_types();
+	std::vector<mono_type> result;
+	auto base_class = base.get_internal_ptr();
+	if(!image_ || !base_class)
+	{
+		return result;
+	}
+	const auto& index = get_inheritance_index(image_);
+
+	// same rules as mono_class_is_subclass_of: everything derives from object
+	if(base_class == mono_get_object_class())
+	{
+		result.reserve(index.classes.size());
+		for(auto klass : index.classes)
+		{
+			result.emplace_back(mono_type(klass));
+		}
+		return result;
+	}
+
+	// an interface is derived by its implementors and the interfaces declaring it
+	if(is_interface_class(base_class))
+	{
+		result = get_types_implementing(base);
+		auto it = index.declarers.find(base_class);
+		if(it != index.declarers.end())
+		{
+			for(auto klass : it->second)
+			{
+				if(is_interface_class(klass))
+				{
+					result.emplace_back(mono_type(klass));
+				}
+			}
+		}
+		return result;
+	}
 
+	// a class is derived from itself
+	std::vector<MonoClass*> pending{base_class};
+	while(!pending.empty())
+	{
+		auto klass = pending.back();
+		pending.pop_back();
+		if(mono_class_get_image(klass) == image_)
+		{
+			result.emplace_back(mono_type(klass));
+		}
+		auto it = index.children.find(klass);
+		if(it != index.children.end())
+		{
+			pending.insert(pending.end(), it->second.begin(), it->second.end());
+		}
+	}
+	return result;
+}
+
+auto mono_assembly::get_direct_subtypes(const mono_type& base) const -> std::vector<mono_type>
+{
 	std::vector<mono_type> result;
+	auto base_class = base.get_internal_ptr();
+	if(!image_ || !base_class)
+	{
+		return result;
+	}
+	const auto& index = get_inheritance_index(image_);
+	const auto& edges = is_interface_class(base_class) ? index.declarers : index.children;
+	auto it = edges.find(base_class);
+	if(it == edges.end())
+	{
+		return result;
+	}
 
-	for(const auto& type : types)
+	result.reserve(it->second.size());
+	for(auto klass : it->second)
 	{
-		if(type.is_derived_from(base))
+		if(mono_class_get_image(klass) == image_)
 		{
-			result.emplace_back(type);
+			result.emplace_back(mono_type(klass));
 		}
 	}
+	return result;
+}
+
+auto mono_assembly::get_types_implementing(const mono_type& iface) const -> std::vector<mono_type>
+{
+	std::vector<mono_type> result;
+	if(!image_ || !iface.valid())
+	{
+		return result;
+	}
+	const auto& index = get_inheritance_index(image_);
+	auto it = index.implementors.find(iface.get_internal_ptr());
+	if(it == index.implementors.end())
+	{
+		return result;
+	}
 
+	result.reserve(it->second.size());
+	for(auto klass : it->second)
+	{
+		result.emplace_back(mono_type(klass));
+	}
 	return result;
 }
 
+auto mono_assembly::get_type_index_stats() const -> type_index_stats
+{
+	type_index_stats stats;
+	if(!image_)
+	{
+		return stats;
+	}
+	const auto& index = get_type_name_index(image_);
+	stats.hits = index.hits.load();
+	stats.misses = index.misses.load();
+	if(auto tokens = index.tokens.get_if_ready())
+	{
+		stats.size = (*tokens)->size();
+	}
+	stats.from_snapshot = index.from_snapshot.load();
+	return stats;
+}
+
+auto mono_assembly::save_metadata_snapshot(const std::string& path, const std::vector<mono_assembly>& assemblies)
+	-> bool
+{
+	std::string data(snapshot_magic, sizeof(snapshot_magic));
+	write_u32(data, snapshot_version);
+	auto count_offset = data.size();
+	write_u32(data, 0);
+
+	auto cached_classes = detail::get_cached_classes();
+	uint32_t images = 0;
+	for(const auto& assembly : assemblies)
+	{
+		auto image = assembly.image_;
+		auto guid = image ? mono_image_get_guid(image) : nullptr;
+		if(!guid || !*guid)
+		{
+			continue;
+		}
+
+		const auto& tokens = get_type_name_tokens(image, get_type_name_index(image));
+		write_string(data, guid);
+		write_u32(data, uint32_t(mono_image_get_table_rows(image, MONO_TABLE_TYPEDEF)));
+		write_u32(data, uint32_t(tokens.size()));
+		for(const auto& token : tokens)
+		{
+			write_u32(data, token.second);
+			write_string(data, token.first);
+		}
+
+		// the member tables of the types in use, so the ones a warm start needs
+		std::vector<std::pair<uint32_t, MonoClass*>> types;
+		for(auto cls : cached_classes)
+		{
+			auto token = mono_class_get_type_token(cls);
+			if(mono_class_get_image(cls) == image && is_type_definition(cls, image, token))
+			{
+				types.emplace_back(token, cls);
+			}
+		}
+		write_u32(data, uint32_t(types.size()));
+		for(const auto& type : types)
+		{
+			write_u32(data, type.first);
+			write_members(data, type.second);
+		}
+		images++;
+	}
+
+	std::string count;
+	write_u32(count, images);
+	data.replace(count_offset, count.size(), count);
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if(!file.is_open())
+	{
+		return false;
+	}
+	file.write(data.data(), std::streamsize(data.size()));
+	return file.good();
+}
+
+auto mono_assembly::load_metadata_snapshot(const std::string& path) -> std::size_t
+{
+	std::ifstream file(path, std::ios::binary);
+	if(!file.is_open())
+	{
+		return 0;
+	}
+	std::vector<char> buffer;
+	if(!read_stream_into_container(file, buffer))
+	{
+		return 0;
+	}
+
+	snapshot_entries entries;
+	if(!parse_snapshot(buffer, entries))
+	{
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> lock(get_snapshot_mutex());
+	get_snapshot_entries() = std::move(entries);
+	snapshot_loaded = !get_snapshot_entries().empty();
+	return get_snapshot_entries().size();
+}
+
+void reset_assembly_cache()
+{
+	get_type_index_cache().clear();
+	get_inheritance_cache().clear();
+}
+
+namespace detail
+{
+auto find_snapshot_members(MonoClass* cls) -> std::shared_ptr<const snapshot_members>
+{
+	if(!cls || !snapshot_loaded.load(std::memory_order_acquire))
+	{
+		return nullptr;
+	}
+
+	auto image = mono_class_get_image(cls);
+	auto entry = find_snapshot_entry(image);
+	if(!entry)
+	{
+		return nullptr;
+	}
+	auto token = mono_class_get_type_token(cls);
+	auto it = entry->members.find(token);
+	if(it == entry->members.end() || !is_type_definition(cls, image, token))
+	{
+		return nullptr;
+	}
+	// shares ownership of the whole entry, a later load doesn't free it
+	return std::shared_ptr<const snapshot_members>(entry, &it->second);
+}
+} // namespace detail
+
 auto mono_assembly::dump_references() const -> std::vector<std::string>
 {
 	std::vector<std::string> refs;
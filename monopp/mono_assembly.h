@@ -12,6 +12,16 @@ namespace mono
 
 class mono_domain;
 
+/// Counters of the per-image type name index.
+struct type_index_stats
+{
+	std::uint64_t hits = 0;
+	std::uint64_t misses = 0;
+	std::size_t size = 0;
+	/// The index was read from a metadata snapshot instead of the TypeDef table.
+	bool from_snapshot = false;
+};
+
 class mono_assembly
 {
 public:
@@ -22,15 +32,79 @@ public:
 	auto get_type(const std::string& name_space, const std::string& name) const -> mono_type;
 
 	auto get_types() const -> std::vector<mono_type>;
+
+	/// Types of this assembly for which type.is_derived_from(base) holds, in no
+	/// particular order. Served from an inheritance index of the image that is
+	/// built on the first query, so a query costs about the size of its result.
 	auto get_types_derived_from(const mono_type& base) const -> std::vector<mono_type>;
 
+	/// Types of this assembly whose parent is base, or which list base
+	/// among their own interfaces when base is an interface.
+	auto get_direct_subtypes(const mono_type& base) const -> std::vector<mono_type>;
+
+	/// Classes of this assembly implementing the interface, including through base classes.
+	auto get_types_implementing(const mono_type& iface) const -> std::vector<mono_type>;
+
+	/// Metadata token lookups. Tokens are only stable within one build of an
+	/// assembly, see get_mvid(). The type and method lookups return invalid
+	/// wrappers for unknown tokens, the field lookup throws.
+	auto get_type_by_token(uint32_t token) const -> mono_type;
+	auto get_method_by_token(uint32_t token) const -> mono_method;
+	auto get_field_by_token(uint32_t token) const -> mono_field;
+
+	/// Module version id of the image, unique to each build of the assembly.
+	auto get_mvid() const -> std::string;
 
 	static auto get_corlib() -> mono_assembly;
 	auto dump_references() const -> std::vector<std::string>;
 
+	/// Stats of the type name index of this assembly's image.
+	/// The index is built on the first nested or dotted name lookup.
+	auto get_type_index_stats() const -> type_index_stats;
+
+	/// Writes the metadata of the assemblies to a binary snapshot, keyed by
+	/// each image's MVID: the type name index and, for every type of the
+	/// image in the type cache, its declared field and method tokens.
+	/// Returns false if the file can't be written.
+	static auto save_metadata_snapshot(const std::string& path, const std::vector<mono_assembly>& assemblies)
+		-> bool;
+
+	/// Reads a snapshot written by save_metadata_snapshot. Images whose MVID
+	/// and TypeDef row count match take their type name index and the member
+	/// tables of the recorded types from it instead of enumerating metadata,
+	/// and methods of those types are found by name without loading the
+	/// others. The snapshot outlives reset_assembly_cache() and replaces the
+	/// previously loaded one. Returns the number of images in it, 0 if the
+	/// file is missing or invalid, which leaves the current one in place.
+	static auto load_metadata_snapshot(const std::string& path) -> std::size_t;
+
 private:
 	non_owning_ptr<MonoAssembly> assembly_ = nullptr;
 	non_owning_ptr<MonoImage> image_ = nullptr;
 };
 
+void reset_assembly_cache();
+
+namespace detail
+{
+/// The declared members of a class as recorded in a metadata snapshot.
+struct snapshot_members
+{
+	struct method_record
+	{
+		uint32_t token = 0;
+		int param_count = 0;
+		std::string name;
+	};
+
+	std::vector<uint32_t> fields;
+	// in declaration order, like mono_class_get_methods
+	std::vector<method_record> methods;
+};
+
+/// The recorded members of a type definition, nullptr when the loaded
+/// snapshot has no matching image or didn't record the class.
+auto find_snapshot_members(MonoClass* cls) -> std::shared_ptr<const snapshot_members>;
+} // namespace detail
+
 } // namespace mono
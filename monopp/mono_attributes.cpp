@@ -0,0 +1,109 @@
+#include "mono_attributes.h"
+#include "mono_object.h"
+#include "mono_type.h"
+
+#include <cstring>
+
+namespace mono
+{
+namespace detail
+{
+
+namespace
+{
+auto matches_name(MonoClass* klass, const std::string& name, bool full) -> bool
+{
+	if(!full || mono_class_get_nesting_type(klass))
+	{
+		// nested names are composed by mono_type, the rest is compared in place
+		return full ? mono_type(klass).get_fullname() == name : name == mono_class_get_name(klass);
+	}
+
+	auto ns = mono_class_get_namespace(klass);
+	auto class_name = mono_class_get_name(klass);
+	auto ns_size = std::strlen(ns);
+	if(ns_size == 0)
+	{
+		return name == class_name;
+	}
+	return name.size() == ns_size + 1 + std::strlen(class_name) && name.compare(0, ns_size, ns) == 0 &&
+		   name[ns_size] == '.' && name.compare(ns_size + 1, std::string::npos, class_name) == 0;
+}
+} // namespace
+
+auto get_attribute_classes(MonoCustomAttrInfo* info) -> std::vector<MonoClass*>
+{
+	std::vector<MonoClass*> classes;
+	if(!info)
+	{
+		return classes;
+	}
+
+	classes.reserve(size_t(info->num_attrs));
+	for(int i = 0; i < info->num_attrs; ++i)
+	{
+		if(auto attr_class = mono_method_get_class(info->attrs[i].ctor))
+		{
+			classes.push_back(attr_class);
+		}
+	}
+	mono_custom_attrs_free(info);
+	return classes;
+}
+
+auto find_attribute_class(const std::vector<MonoClass*>& classes, MonoClass* attribute) -> MonoClass*
+{
+	if(!attribute)
+	{
+		return nullptr;
+	}
+	for(auto klass : classes)
+	{
+		if(klass == attribute || mono_class_is_subclass_of(klass, attribute, false))
+		{
+			return klass;
+		}
+	}
+	return nullptr;
+}
+
+auto find_attribute_class(const std::vector<MonoClass*>& classes, const std::string& name, bool full)
+	-> MonoClass*
+{
+	for(auto klass : classes)
+	{
+		if(matches_name(klass, name, full))
+		{
+			return klass;
+		}
+	}
+	return nullptr;
+}
+
+auto create_attributes(MonoCustomAttrInfo* info, MonoClass* attribute) -> std::vector<mono_object>
+{
+	std::vector<mono_object> result;
+	if(!info)
+	{
+		return result;
+	}
+
+	result.reserve(size_t(info->num_attrs));
+	for(int i = 0; i < info->num_attrs; ++i)
+	{
+		auto attr_class = mono_method_get_class(info->attrs[i].ctor);
+		if(!attr_class || (attribute && attr_class != attribute))
+		{
+			continue;
+		}
+		if(auto attr_obj = mono_custom_attrs_get_attr(info, attr_class))
+		{
+			result.emplace_back(attr_obj);
+		}
+	}
+	mono_custom_attrs_free(info);
+	return result;
+}
+
+} // namespace detail
+} // namespace mono
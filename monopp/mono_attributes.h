@@ -0,0 +1,35 @@
+#pragma once
+
+#include "mono_config.h"
+
+BEGIN_MONO_INCLUDE
+#include <mono/metadata/class.h>
+#include <mono/metadata/reflection.h>
+END_MONO_INCLUDE
+
+#include <string>
+#include <vector>
+
+namespace mono
+{
+class mono_object;
+
+namespace detail
+{
+/// The attribute classes of one member in declaration order, read from
+/// the constructor of every entry. Frees info, nothing gets instantiated.
+auto get_attribute_classes(MonoCustomAttrInfo* info) -> std::vector<MonoClass*>;
+
+/// The first class that is attribute or derives from it, nullptr if none.
+auto find_attribute_class(const std::vector<MonoClass*>& classes, MonoClass* attribute) -> MonoClass*;
+
+/// The first class named name (or full_name when full is set), nullptr if none.
+auto find_attribute_class(const std::vector<MonoClass*>& classes, const std::string& name, bool full)
+	-> MonoClass*;
+
+/// Instantiates the attributes of info, only those of the given class when
+/// it is set. Frees info.
+auto create_attributes(MonoCustomAttrInfo* info, MonoClass* attribute = nullptr) -> std::vector<mono_object>;
+
+} // namespace detail
+} // namespace mono
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "mono_method_invoker.h"
+
+#include <tuple>
+#include <vector>
+
+namespace mono
+{
+
+/// A managed exception thrown by a single element of a batch.
+struct batch_error
+{
+	std::size_t index{};
+	mono_thunk_exception exception;
+};
+
+template <typename T>
+struct batch_result
+{
+	/// One value per element, default constructed for elements that failed.
+	std::vector<T> values;
+	std::vector<batch_error> errors;
+
+	auto succeeded() const -> bool
+	{
+		return errors.empty();
+	}
+};
+
+template <>
+struct batch_result<void>
+{
+	std::vector<batch_error> errors;
+
+	auto succeeded() const -> bool
+	{
+		return errors.empty();
+	}
+};
+
+template <typename T>
+class mono_batch_invoker;
+
+/// Invokes one method over many receivers and/or argument tuples.
+/// The validity check, parameter types, thunk and argument conversion
+/// (when shared) are resolved once per batch, virtual resolution goes
+/// through the invoker's inline cache and a managed exception only fails
+/// its own element.
+template <typename RetType, typename... Args>
+class mono_batch_invoker<RetType(Args...)> : public mono_method_invoker_base
+{
+public:
+	using value_type = std::decay_t<RetType>;
+	using args_tuple = std::tuple<std::decay_t<Args>...>;
+	using result_type = batch_result<value_type>;
+
+	/// Invoke on every receiver with the same arguments.
+	auto operator()(const std::vector<mono_object>& objects, Args... args) -> result_type
+	{
+		auto tup = std::make_tuple(mono_converter<std::decay_t<Args>>::to_mono(std::forward<Args>(args))...);
+		return run(objects.size(), [&](std::size_t i) { return call_one(&objects[i], tup); });
+	}
+
+	/// Invoke once per argument tuple without a receiver (static methods).
+	auto operator()(const std::vector<args_tuple>& args_list) -> result_type
+	{
+		return run(args_list.size(),
+				   [&](std::size_t i)
+				   {
+					   auto tup = convert(args_list[i], std::index_sequence_for<Args...>{});
+					   return call_one(nullptr, tup);
+				   });
+	}
+
+	/// Invoke objects[i] with args_list[i].
+	auto operator()(const std::vector<mono_object>& objects, const std::vector<args_tuple>& args_list)
+		-> result_type
+	{
+		if(objects.size() != args_list.size())
+		{
+			throw mono_exception("NATIVE::Batch invoke requested with mismatched receivers and arguments");
+		}
+		return run(objects.size(),
+				   [&](std::size_t i)
+				   {
+					   auto tup = convert(args_list[i], std::index_sequence_for<Args...>{});
+					   return call_one(&objects[i], tup);
+				   });
+	}
+
+private:
+	template <typename Signature>
+	friend auto make_batch_invoker(const mono_method_invoker<Signature>&) -> mono_batch_invoker<Signature>;
+
+	explicit mono_batch_invoker(const mono_method_invoker_base& invoker)
+		: mono_method_invoker_base(invoker)
+	{
+	}
+
+	template <std::size_t... I>
+	static auto convert(const args_tuple& args, std::index_sequence<I...>)
+	{
+		mono::ignore(args);
+		return std::make_tuple(mono_converter<std::decay_t<Args>>::to_mono(std::get<I>(args))...);
+	}
+
+	template <typename Tuple>
+	auto call_one(const mono_object* obj, Tuple& tup) -> value_type
+	{
+		MonoObject* object = nullptr;
+		MonoMethod* method = nullptr;
+		void* thunk = nullptr;
+		resolve_target(obj, object, method, thunk);
+		return detail::invoke_caller<RetType, Args...>::call(method, thunk, is_static_, object, *param_types_,
+															 tup);
+	}
+
+	template <typename F>
+	auto run(std::size_t count, F&& f) -> result_type
+	{
+		if(!this->method_)
+		{
+			throw mono_exception("NATIVE::Method thunk requested with invalid method");
+		}
+		param_types_ = &this->get_param_types();
+
+		result_type result;
+		reserve(result, count);
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			try
+			{
+				store(result, i, f);
+			}
+			catch(const mono_thunk_exception& e)
+			{
+				result.errors.push_back({i, e});
+			}
+		}
+		return result;
+	}
+
+	template <typename T>
+	static void reserve(batch_result<T>& result, std::size_t count)
+	{
+		result.values.resize(count);
+	}
+
+	static void reserve(batch_result<void>&, std::size_t)
+	{
+	}
+
+	template <typename T, typename F>
+	static void store(batch_result<T>& result, std::size_t i, F& f)
+	{
+		result.values[i] = f(i);
+	}
+
+	template <typename F>
+	static void store(batch_result<void>&, std::size_t i, F& f)
+	{
+		f(i);
+	}
+
+	const std::vector<mono_type>* param_types_ = nullptr;
+};
+
+template <typename Signature>
+auto make_batch_invoker(const mono_method_invoker<Signature>& invoker) -> mono_batch_invoker<Signature>
+{
+	return mono_batch_invoker<Signature>(invoker);
+}
+
+template <typename Signature>
+auto make_batch_invoker(const mono_method& method, bool check_signature = true)
+	-> mono_batch_invoker<Signature>
+{
+	return make_batch_invoker<Signature>(make_method_invoker<Signature>(method, check_signature));
+}
+
+template <typename Signature>
+auto make_batch_invoker(const mono_type& type, const std::string& name) -> mono_batch_invoker<Signature>
+{
+	return make_batch_invoker<Signature>(make_method_invoker<Signature>(type, name));
+}
+
+} // namespace mono
@@ -0,0 +1,60 @@
+#include "mono_binding.h"
+#include "mono_exception.h"
+
+namespace mono
+{
+
+mono_binding_context::mono_binding_context(const mono_assembly& assembly, const std::string& mvid)
+	: assembly_(assembly)
+	, uses_tokens_(!mvid.empty() && assembly.get_mvid() == mvid)
+{
+}
+
+auto mono_binding_context::uses_tokens() const -> bool
+{
+	return uses_tokens_;
+}
+
+auto mono_binding_context::get_type(uint32_t token, const std::string& full_name) const -> mono_type
+{
+	auto type = uses_tokens_ ? assembly_.get_type_by_token(token) : assembly_.get_type(full_name);
+	if(!type.valid())
+	{
+		throw mono_exception("NATIVE::Could not bind type : " + full_name);
+	}
+	return type;
+}
+
+auto mono_binding_context::get_method(const mono_type& type, uint32_t token,
+									  const std::string& name_with_args) const -> mono_method
+{
+	if(uses_tokens_)
+	{
+		auto method = assembly_.get_method_by_token(token);
+		if(!method.valid())
+		{
+			throw mono_exception("NATIVE::Could not bind method : " + name_with_args + " for class " +
+								 type.get_name());
+		}
+		return method;
+	}
+	return type.get_method(name_with_args);
+}
+
+auto mono_binding_context::get_field(const mono_type& type, uint32_t token, const std::string& name) const
+	-> mono_field
+{
+	if(uses_tokens_)
+	{
+		return assembly_.get_field_by_token(token);
+	}
+	return type.get_field(name);
+}
+
+auto mono_binding_context::get_property(const mono_type& type, const std::string& name) const -> mono_property
+{
+	// properties have no token lookup in the embedding API
+	return type.get_property(name);
+}
+
+} // namespace mono
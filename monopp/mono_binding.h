@@ -0,0 +1,40 @@
+#pragma once
+
+#include "mono_config.h"
+
+#include "mono_assembly.h"
+#include "mono_field.h"
+#include "mono_method.h"
+#include "mono_property.h"
+
+namespace mono
+{
+
+/// Resolves the members of bindings generated by monopp_bindgen.
+/// When the assembly is the build the bindings were generated from (same
+/// MVID) members are resolved by their metadata tokens, otherwise by name,
+/// so a rebuilt assembly still binds as long as the members exist.
+/// Throws mono_exception for members that can't be resolved.
+class mono_binding_context
+{
+public:
+	explicit mono_binding_context(const mono_assembly& assembly, const std::string& mvid);
+
+	/// True if the assembly matches the MVID and tokens are used.
+	auto uses_tokens() const -> bool;
+
+	auto get_type(uint32_t token, const std::string& full_name) const -> mono_type;
+
+	auto get_method(const mono_type& type, uint32_t token, const std::string& name_with_args) const
+		-> mono_method;
+
+	auto get_field(const mono_type& type, uint32_t token, const std::string& name) const -> mono_field;
+
+	auto get_property(const mono_type& type, const std::string& name) const -> mono_property;
+
+private:
+	mono_assembly assembly_;
+	bool uses_tokens_ = false;
+};
+
+} // namespace mono
@@ -46,6 +46,12 @@ using non_owning_ptr = T*;
 #define DIAG_POP_PRAGMA DIAG_PRAGMA(GCC, pop)
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+#define MONOPP_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define MONOPP_PREFETCH(address) ((void)(address))
+#endif
+
 #define BEGIN_MONO_INCLUDE                                                                                   \
 	DIAG_PUSH_PRAGMA                                                                                         \
 	DIAG_DISABLE_WARNING(pedantic, pedantic, 4201)
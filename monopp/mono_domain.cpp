@@ -7,6 +7,8 @@
 #include "mono_method.h"
 #include "mono_property.h"
 #include "mono_field.h"
+#include "mono_list.h"
+#include "mono_thread.h"
 
 BEGIN_MONO_INCLUDE
 #include <mono/metadata/appdomain.h>
@@ -57,6 +59,7 @@ void mono_domain::set_current_domain(const mono_domain& domain)
 void mono_domain::set_current_domain(const mono_domain* domain)
 {
 	current_domain = domain;
+	set_thread_attach_domain(current_domain ? current_domain->domain_ : nullptr);
 
 	if(current_domain)
 	{
@@ -88,6 +91,7 @@ auto mono_domain::new_string(const std::string& str) const -> mono_string
 }
 
 mono_domain::mono_domain(const std::string& name)
+	: serial_(detail::enter_domain_epoch())
 {
 	domain_ = mono_domain_create_appdomain(const_cast<char*>(name.c_str()), nullptr);
 
@@ -102,6 +106,8 @@ mono_domain::~mono_domain()
 {
 	if(domain_)
 	{
+		invalidate_thread_attachments(domain_);
+
 		std::string err;
 		if(mono_managed_gc_collect(err))
 		{
@@ -120,10 +126,10 @@ mono_domain::~mono_domain()
 		}
 	}
 	mono_gc_collect(mono_gc_max_generation());
-	reset_type_cache();
-	reset_method_cache();
-	reset_property_cache();
-	reset_field_cache();
+	// wrappers of the domains still alive may point into the caches, so
+	// their contents are freed only once those domains are gone as well
+	detail::leave_domain_epoch(serial_);
+	detail::retire_meta_caches();
 }
 
 auto mono_domain::get_assembly(const std::string& path, bool shared) const -> mono_assembly
@@ -136,50 +142,66 @@ auto mono_domain::get_assembly(const std::string& path, bool shared) const -> mo
 		return assembly;
 	}
 	auto res = assemblies_.emplace(path, mono_assembly{*this, path, shared});
+	// cached misses may resolve now; retired rather than cleared since
+	// get_type may be probing it on another thread
+	type_cache_.retire();
 
 	const auto& assembly = res.first->second;
 
 	return assembly;
 }
 
-auto mono_domain::get_type(const std::string& name) const -> mono_type
+template <typename F>
+auto mono_domain::resolve_type(const std::string& key, F&& find_in) const -> mono_type
 {
-	for(const auto& assembly : assemblies_)
+	if(auto cached = type_cache_.find(key))
 	{
-		auto type = assembly.second.get_type(name);
-		if(type.valid())
+		if(*cached)
 		{
-			return type;
+			return mono_type(*cached);
 		}
+		return {};
 	}
 
-	auto type = mono_assembly::get_corlib().get_type(name);
-	if(type.valid())
-	{
-		return type;
-	}
-	return {};
-}
-
-auto mono_domain::get_type(const std::string& name_space, const std::string& name) const -> mono_type
-{
+	MonoClass* cls = nullptr;
 	for(const auto& assembly : assemblies_)
 	{
-		auto type = assembly.second.get_type(name_space, name);
+		auto type = find_in(assembly.second);
 		if(type.valid())
 		{
-			return type;
+			cls = type.get_internal_ptr();
+			break;
 		}
 	}
-	
-	auto type = mono_assembly::get_corlib().get_type(name_space, name);
-	if(type.valid())
+
+	if(!cls)
 	{
-		return type;
+		auto type = find_in(mono_assembly::get_corlib());
+		cls = type.get_internal_ptr();
+	}
+
+	type_cache_.emplace(key, cls);
+	if(cls)
+	{
+		return mono_type(cls);
 	}
 	return {};
 }
 
+auto mono_domain::get_type(const std::string& name) const -> mono_type
+{
+	return resolve_type(name, [&](const mono_assembly& assembly) { return assembly.get_type(name); });
+}
+
+auto mono_domain::get_type(const std::string& name_space, const std::string& name) const -> mono_type
+{
+	// '\0' can't appear in type names, so the key never clashes with a plain name
+	auto key = name_space;
+	key.push_back('\0');
+	key += name;
+	return resolve_type(key, [&](const mono_assembly& assembly) { return assembly.get_type(name_space, name); });
+}
+
 auto mono_domain::get_name() const -> std::string
 {
 	return mono_domain_get_friendly_name(domain_);
@@ -3,6 +3,7 @@
 #include "mono_config.h"
 
 #include "mono_assembly.h"
+#include "mono_meta_cache.h"
 
 BEGIN_MONO_INCLUDE
 #include <mono/metadata/metadata.h>
@@ -40,9 +41,16 @@ public:
 	auto get_internal_ptr() const -> MonoDomain*;
 
 private:
+	template <typename F>
+	auto resolve_type(const std::string& key, F&& find_in) const -> mono_type;
 
 	mutable std::unordered_map<std::string, mono_assembly> assemblies_;
+	/// Resolved types by name, nullptr for names that were not found.
+	/// Retired whenever get_assembly loads a new assembly.
+	mutable mono_meta_cache<std::string, MonoClass*> type_cache_;
 	non_owning_ptr<MonoDomain> domain_ = nullptr;
+	/// Orders the domains for freeing retired cache generations.
+	std::uint64_t serial_ = 0;
 };
 
 } // namespace mono
@@ -1,48 +1,48 @@
 #include "mono_field.h"
+#include "mono_attributes.h"
 #include "mono_domain.h"
 #include "mono_exception.h"
 #include "mono_object.h"
+#include "mono_meta_cache.h"
 
-#include <unordered_map>
+#include <mono_build_config.h>
 
 BEGIN_MONO_INCLUDE
 #include <mono/metadata/appdomain.h>
 #include <mono/metadata/attrdefs.h>
 #include <mono/metadata/debug-helpers.h>
 END_MONO_INCLUDE
+
+#if MONOPP_HAS_VTABLE_STATIC_FIELD_DATA
+// Exported by the runtime for the debugger but not declared in the public
+// headers. Checked against mono 6.12.0.206; detected at configure time, so a
+// runtime without it falls back to mono_field_static_get/set_value.
+extern "C" void* mono_vtable_get_static_field_data(MonoVTable* vt);
+#endif
+
 namespace mono
 {
 struct mono_field::meta_info
 {
-	std::string name;
-	std::string fullname;
-	std::string full_declname;
+	lazy_value<std::string> name;
+	lazy_value<std::string> fullname;
+	lazy_value<std::string> full_declname;
+	lazy_value<std::vector<MonoClass*>> attribute_classes;
 };
 
 namespace
 {
 
-auto get_field_cache() -> std::unordered_map<MonoClassField*, std::shared_ptr<mono_field::meta_info>>&
+auto get_field_cache() -> mono_meta_cache<MonoClassField*, mono_field::meta_info>&
 {
-	static std::unordered_map<MonoClassField*, std::shared_ptr<mono_field::meta_info>> field_cache;
+	static mono_meta_cache<MonoClassField*, mono_field::meta_info> field_cache;
 	return field_cache;
 }
 
-auto get_meta_info(MonoClassField* field) -> std::shared_ptr<mono_field::meta_info>
+auto get_meta_info(MonoClassField* field) -> mono_field::meta_info*
 {
 	auto& cache = get_field_cache();
-	auto it = cache.find(field);
-	if(it != cache.end())
-	{
-		return it->second;
-	}
-	return nullptr;
-}
-
-void set_meta_info(MonoClassField* field, std::shared_ptr<mono_field::meta_info> meta)
-{
-	auto& cache = get_field_cache();
-	cache[field] = meta;
+	return &cache.find_or_emplace(field);
 }
 
 } // namespace
@@ -61,6 +61,21 @@ mono_field::mono_field(const mono_type& type, const std::string& name)
 	{
 		throw mono_exception("NATIVE::Could not get field : " + name + " for class " + type.get_name());
 	}
+	init();
+}
+
+mono_field::mono_field(MonoClassField* field)
+	: field_(field)
+{
+	if(!field_)
+	{
+		throw mono_exception("NATIVE::Could not get field : null handle");
+	}
+	init();
+}
+
+void mono_field::init()
+{
 	const auto& domain = mono_domain::get_current_domain();
 
 	if(is_static())
@@ -80,17 +95,8 @@ mono_field::mono_field(const mono_type& type, const std::string& name)
 
 void mono_field::generate_meta()
 {
-	auto meta = get_meta_info(field_);
-	if(!meta)
-	{
-		meta = std::make_shared<meta_info>();
-		meta->name = get_name();
-		meta->fullname = get_fullname();
-		meta->full_declname = get_full_declname();
-		set_meta_info(field_, meta);
-	}
-
-	meta_ = meta;
+	// attributes are computed on first access
+	meta_ = get_meta_info(field_);
 }
 
 auto mono_field::is_valuetype() const -> bool
@@ -98,34 +104,66 @@ auto mono_field::is_valuetype() const -> bool
 	return get_type().is_valuetype();
 }
 
+auto mono_field::get_static_address() const -> void*
+{
+	if(!is_static() || is_const() || !owning_type_vtable_)
+	{
+		return nullptr;
+	}
+	// thread and context statics have no offset, they live in per-thread storage
+	auto offset = mono_field_get_offset(field_);
+	if(offset == uint32_t(-1))
+	{
+		return nullptr;
+	}
+#if MONOPP_HAS_VTABLE_STATIC_FIELD_DATA
+	auto data = static_cast<char*>(mono_vtable_get_static_field_data(owning_type_vtable_));
+	return data ? data + offset : nullptr;
+#else
+	return nullptr;
+#endif
+}
+
 auto mono_field::get_name() const -> std::string
 {
+	auto compute = [this]() -> std::string
+	{
+		return mono_field_get_name(field_);
+	};
 	if(meta_)
 	{
-		return meta_->name;
+		return meta_->name.get(compute);
 	}
-	return mono_field_get_name(field_);
+	return compute();
 }
 auto mono_field::get_fullname() const -> std::string
 {
+	auto compute = [this]() -> std::string
+	{
+		char* mono_name = mono_field_full_name(field_);
+		std::string name(mono_name);
+		mono_free(mono_name);
+		return name;
+	};
 	if(meta_)
 	{
-		return meta_->fullname;
+		return meta_->fullname.get(compute);
 	}
-	char* mono_name = mono_field_full_name(field_);
-	std::string name(mono_name);
-	mono_free(mono_name);
-	return name;
+	return compute();
 }
 
 auto mono_field::get_full_declname() const -> std::string
 {
+	auto compute = [this]() -> std::string
+	{
+		std::string storage = (is_static() ? " static " : " ");
+		return to_string(get_visibility()) + storage + get_fullname();
+	};
 	if(meta_)
 	{
-		return meta_->full_declname;
+		return meta_->full_declname.get(compute);
 	}
-	std::string storage = (is_static() ? " static " : " ");
-	return to_string(get_visibility()) + storage + get_fullname();
+	return compute();
 }
 auto mono_field::get_type() const -> const mono_type&
 {
@@ -159,42 +197,29 @@ auto mono_field::is_static() const -> bool
 	return (flags & MONO_FIELD_ATTR_STATIC) != 0;
 }
 
-auto mono_field::get_attributes() const -> std::vector<mono_object>
+auto mono_field::get_attribute_classes() const -> const std::vector<MonoClass*>&
 {
-	std::vector<mono_object> result;
-
-	auto parent_class = mono_field_get_parent(field_);
-	// Get custom attributes from the field
-	MonoCustomAttrInfo* attr_info = mono_custom_attrs_from_field(parent_class, field_);
+	auto compute = [this]() -> std::vector<MonoClass*>
+	{
+		return detail::get_attribute_classes(mono_custom_attrs_from_field(mono_field_get_parent(field_), field_));
+	};
+	return meta_->attribute_classes.get(compute);
+}
 
-	if(attr_info)
+auto mono_field::create_attributes(MonoClass* attribute) const -> std::vector<mono_object>
+{
+	// nothing is instantiated for fields without attributes
+	if(get_attribute_classes().empty())
 	{
-		result.reserve(attr_info->num_attrs);
-
-		// Iterate over the custom attributes
-		for(int i = 0; i < attr_info->num_attrs; ++i)
-		{
-			MonoCustomAttrEntry* entry = &attr_info->attrs[i];
-
-			// Get the MonoClass* of the attribute
-			MonoClass* attr_class = mono_method_get_class(entry->ctor);
-
-			if(attr_class)
-			{
-				MonoObject* attr_obj = mono_custom_attrs_get_attr(attr_info, attr_class);
-				// Add the attribute instance to the result vector
-				if(attr_obj)
-				{
-					result.emplace_back(attr_obj);
-				}
-			}
-		}
-
-		// Free the attribute info when done
-		mono_custom_attrs_free(attr_info);
+		return {};
 	}
+	return detail::create_attributes(mono_custom_attrs_from_field(mono_field_get_parent(field_), field_),
+									 attribute);
+}
 
-	return result;
+auto mono_field::get_attributes() const -> std::vector<mono_object>
+{
+	return create_attributes(nullptr);
 }
 
 auto mono_field::is_readonly() const -> bool
@@ -203,6 +228,11 @@ auto mono_field::is_readonly() const -> bool
 	return (flags & MONO_FIELD_ATTR_INIT_ONLY) != 0;
 }
 
+auto mono_field::is_blittable() const -> bool
+{
+	return type_.is_blittable();
+}
+
 auto mono_field::is_const() const -> bool
 {
 	uint32_t flags = mono_field_get_flags(field_);
@@ -211,36 +241,42 @@ auto mono_field::is_const() const -> bool
 
 auto mono_field::has_attribute_fullname(const std::string& attribute_full_name) const -> bool
 {
-	return get_attribute_fullname(attribute_full_name).valid();
+	return detail::find_attribute_class(get_attribute_classes(), attribute_full_name, true) != nullptr;
 }
 
 auto mono_field::has_attribute(const std::string& attribute_name) const -> bool
 {
-	return get_attribute(attribute_name).valid();
+	return detail::find_attribute_class(get_attribute_classes(), attribute_name, false) != nullptr;
+}
+
+auto mono_field::has_attribute(const mono_type& attribute) const -> bool
+{
+	return detail::find_attribute_class(get_attribute_classes(), attribute.get_internal_ptr()) != nullptr;
 }
 
 auto mono_field::get_attribute(const std::string& attribute_name) const -> mono_object
 {
-	for (auto& attr_obj : get_attributes())
-	{
-		if(attribute_name == attr_obj.get_type().get_name())
-		{
-			return attr_obj;
-		}
-	}
-	return mono_object();
+	return get_attribute(detail::find_attribute_class(get_attribute_classes(), attribute_name, false));
 }
 
 auto mono_field::get_attribute_fullname(const std::string& attribute_full_name) const -> mono_object
 {
-	for (auto& attr_obj : get_attributes())
+	return get_attribute(detail::find_attribute_class(get_attribute_classes(), attribute_full_name, true));
+}
+
+auto mono_field::get_attribute(const mono_type& attribute) const -> mono_object
+{
+	return get_attribute(detail::find_attribute_class(get_attribute_classes(), attribute.get_internal_ptr()));
+}
+
+auto mono_field::get_attribute(MonoClass* attribute) const -> mono_object
+{
+	if(!attribute)
 	{
-		if(attribute_full_name == attr_obj.get_type().get_fullname())
-		{
-			return attr_obj;
-		}
+		return mono_object();
 	}
-	return mono_object();
+	auto attributes = create_attributes(attribute);
+	return attributes.empty() ? mono_object() : attributes.front();
 }
 
 auto mono_field::is_backing_field() const -> bool
@@ -257,9 +293,18 @@ auto mono_field::is_backing_field() const -> bool
 
 	return false;
 }
+
+auto mono_field::get_internal_ptr() const -> MonoClassField*
+{
+	return field_;
+}
+
 void reset_field_cache()
 {
 	auto& cache = get_field_cache();
 	cache.clear();
+
+	// the member tables of the types hold fields of the old cache
+	reset_type_cache();
 }
 } // namespace mono
@@ -19,6 +19,7 @@ public:
 	struct meta_info;
 
 	explicit mono_field(const mono_type& type, const std::string& name);
+	explicit mono_field(MonoClassField* field);
 
 	auto get_name() const -> std::string;
 
@@ -38,30 +39,59 @@ public:
 
 	auto has_attribute(const std::string& attribute_name) const -> bool;
 
+	/// True if the field has an attribute of this class or a derived one.
+	/// Answered from the cached attribute classes, nothing is instantiated.
+	auto has_attribute(const mono_type& attribute) const -> bool;
+
 	auto get_attribute_fullname(const std::string& attribute_full_name) const -> mono_object;
 	
 	auto get_attribute(const std::string& attribute_name) const -> mono_object;
 
+	/// Instantiates only the matching attribute.
+	auto get_attribute(const mono_type& attribute) const -> mono_object;
+
 	auto is_readonly() const -> bool;
 
 	auto is_const() const -> bool;
 
 	auto is_backing_field() const -> bool;
 
+	/// True if the field's type is blittable, see mono_type::is_blittable().
+	auto is_blittable() const -> bool;
+
+	auto get_internal_ptr() const -> MonoClassField*;
+
 protected:
+	void init();
+
 	void generate_meta();
 
+	auto get_attribute_classes() const -> const std::vector<MonoClass*>&;
+
+	auto create_attributes(MonoClass* attribute) const -> std::vector<mono_object>;
+
+	auto get_attribute(MonoClass* attribute) const -> mono_object;
+
 	auto is_valuetype() const -> bool;
 
+	/// Address of a static field in the owning vtable's static data.
+	/// nullptr for instance fields, constants and thread static fields, and
+	/// for all fields when the runtime does not export the static data.
+	auto get_static_address() const -> void*;
+
 	mono_type type_;
 
 	non_owning_ptr<MonoClassField> field_ = nullptr;
 
 	non_owning_ptr<MonoVTable> owning_type_vtable_ = nullptr;
 
-	std::shared_ptr<meta_info> meta_{};
+	/// Owned by the meta cache: freed by reset_field_cache(), and by a domain
+	/// unload once every domain that was alive then is unloaded too.
+	meta_info* meta_ = nullptr;
 };
 
+/// Frees the cached metadata, see reset_type_cache().
+/// Also resets the type cache, whose member tables hold fields.
 void reset_field_cache();
 
 } // namespace mono
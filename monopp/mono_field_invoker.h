@@ -1,11 +1,86 @@
 #pragma once
 #include "mono_field.h"
 
+#include "mono_exception.h"
 #include "mono_object.h"
+#include "mono_thread.h"
 #include "mono_type_conversion.h"
+
+#include <cstring>
+#include <string>
 namespace mono
 {
 
+namespace detail
+{
+template <typename T>
+struct field_access_traits
+{
+	using managed_type = typename mono_converter<T>::managed_type;
+	// T is its own managed representation and can be copied bytewise
+	static constexpr bool by_value = std::is_same<managed_type, T>::value && std::is_trivially_copyable<T>::value;
+	// T converts to and from a managed reference
+	static constexpr bool by_reference = std::is_same<managed_type, MonoObject*>::value;
+};
+
+template <typename T>
+void store_field_value(void* address, const T& value, std::true_type)
+{
+	std::memcpy(address, std::addressof(value), sizeof(T));
+}
+
+template <typename T>
+void store_field_value(void*, const T&, std::false_type)
+{
+}
+
+template <typename T>
+void load_field_value(T& value, const void* address, std::true_type)
+{
+	std::memcpy(std::addressof(value), address, sizeof(T));
+}
+
+template <typename T>
+void load_field_value(T&, const void*, std::false_type)
+{
+}
+
+// obj is null for static fields, which live outside any object
+inline void store_reference(MonoObject* obj, void* address, MonoObject* value)
+{
+	if(obj)
+	{
+		mono_gc_wbarrier_set_field(obj, address, value);
+	}
+	else
+	{
+		mono_gc_wbarrier_generic_store(address, value);
+	}
+}
+
+template <typename T>
+void store_field_reference(MonoObject* obj, void* address, const T& value, std::true_type)
+{
+	store_reference(obj, address, mono_converter<T>::to_mono(value));
+}
+
+template <typename T>
+void store_field_reference(MonoObject*, void*, const T&, std::false_type)
+{
+}
+
+template <typename T>
+void load_field_reference(T& value, const void* address, std::true_type)
+{
+	value = mono_converter<T>::from_mono(*reinterpret_cast<MonoObject* const*>(address));
+}
+
+template <typename T>
+void load_field_reference(T&, const void*, std::false_type)
+{
+}
+} // namespace detail
+
 template <typename T>
 class mono_field_invoker : public mono_field
 {
@@ -20,20 +95,305 @@ public:
 
 	auto get_value(const mono_object& obj) const -> T;
 
+	/// True if values are read and written in place, at the field offset in
+	/// the object or in the owning type's static data, instead of going
+	/// through mono_field_(static_)get/set_value.
+	auto is_direct() const -> bool;
+
+	/// Reads the field of count objects into out, in order.
+	/// Direct fields are read in a single loop over the cached offset.
+	/// Throws mono_exception on a null object unless the field is static.
+	void gather(const mono_object* objects, size_t count, T* out) const;
+	void gather(const std::vector<mono_object>& objects, T* out) const;
+
+	/// Same as gather, with the objects given by gc handles.
+	void gather_handles(const uint32_t* handles, size_t count, T* out) const;
+
+	/// Writes in[i] into the field of objects[i], the inverse of gather.
+	/// Like the direct set_value, reference values are not type checked.
+	void scatter(const mono_object* objects, size_t count, const T* in) const;
+	void scatter(const std::vector<mono_object>& objects, const T* in) const;
+
+	void scatter_handles(const uint32_t* handles, size_t count, const T* in) const;
+
 private:
 	template <typename signature_t>
 	friend auto make_field_invoker(const mono_field&) -> mono_field_invoker<signature_t>;
 
+	// How values are accessed, decided once in the constructor.
+	enum class access_mode
+	{
+		runtime,
+		// T has the layout of a blittable field, bytes are copied as is
+		direct_value,
+		// the field holds a reference, stored through the GC write barrier
+		direct_reference
+	};
+
 	explicit mono_field_invoker(const mono_field& field)
 		: mono_field(field)
 	{
+		init_access();
 	}
 
+	void init_access();
+
+	/// The field's storage: the static data for static fields, the object
+	/// memory for instance fields, nullptr if there is none to access.
+	auto get_address(const mono_object* object) const -> void*;
+
+	/// The object to pass to the write barrier, nullptr for static fields.
+	auto get_owner(const mono_object* object) const -> MonoObject*;
+
+	template <typename GetObject>
+	void gather_impl(size_t count, GetObject&& get_object, T* out) const;
+
+	template <typename GetObject>
+	void scatter_impl(size_t count, GetObject&& get_object, const T* in) const;
+
 	void set_value_impl(const mono_object* obj, const T& val) const;
 
 	auto get_value_impl(const mono_object* obj) const -> T;
+
+	access_mode access_ = access_mode::runtime;
+
+	uint32_t offset_ = 0;
+
+	void* static_address_ = nullptr;
 };
 
+template <typename T>
+void mono_field_invoker<T>::init_access()
+{
+	using traits = detail::field_access_traits<T>;
+	if(is_valuetype())
+	{
+		if(traits::by_value && is_blittable() && get_type().get_sizeof() == sizeof(T))
+		{
+			access_ = access_mode::direct_value;
+		}
+	}
+	else if(traits::by_reference)
+	{
+		access_ = access_mode::direct_reference;
+	}
+
+	if(access_ == access_mode::runtime)
+	{
+		return;
+	}
+
+	if(is_static())
+	{
+		static_address_ = get_static_address();
+		if(!static_address_)
+		{
+			access_ = access_mode::runtime;
+		}
+	}
+	else
+	{
+		offset_ = mono_field_get_offset(field_);
+	}
+}
+
+template <typename T>
+auto mono_field_invoker<T>::is_direct() const -> bool
+{
+	return access_ != access_mode::runtime;
+}
+
+namespace detail
+{
+// how many objects ahead gather/scatter prefetch the field of
+constexpr size_t field_prefetch_distance = 8;
+
+inline auto check_field_target(MonoObject* object, size_t index) -> MonoObject*
+{
+	if(!object)
+	{
+		throw mono_exception("NATIVE::Field access on a null object at index " + std::to_string(index));
+	}
+	return object;
+}
+
+/// Hands out get_object(0), get_object(1)... resolving each object only once,
+/// field_prefetch_distance ahead of its turn so its field gets prefetched.
+template <typename GetObject>
+class field_target_window
+{
+public:
+	field_target_window(size_t count, GetObject& get_object, uint32_t offset)
+		: count_(count)
+		, get_object_(get_object)
+		, offset_(offset)
+	{
+		for(size_t i = 0; i < field_prefetch_distance && i < count_; ++i)
+		{
+			fetch(i);
+		}
+	}
+
+	auto get(size_t i) -> MonoObject*
+	{
+		auto& slot = objects_[i % field_prefetch_distance];
+		auto object = slot;
+		if(i + field_prefetch_distance < count_)
+		{
+			fetch(i + field_prefetch_distance);
+		}
+		return check_field_target(object, i);
+	}
+
+private:
+	void fetch(size_t i)
+	{
+		auto object = get_object_(i);
+		objects_[i % field_prefetch_distance] = object;
+		if(object)
+		{
+			MONOPP_PREFETCH(reinterpret_cast<const char*>(object) + offset_);
+		}
+	}
+
+	size_t count_;
+	GetObject& get_object_;
+	uint32_t offset_;
+	MonoObject* objects_[field_prefetch_distance] = {};
+};
+} // namespace detail
+
+template <typename T>
+template <typename GetObject>
+void mono_field_invoker<T>::gather_impl(size_t count, GetObject&& get_object, T* out) const
+{
+	ensure_thread_attached();
+
+	using traits = detail::field_access_traits<T>;
+	if(access_ == access_mode::runtime || static_address_)
+	{
+		for(size_t i = 0; i < count; ++i)
+		{
+			// a static field has no target, the objects are not even read
+			out[i] = is_static() ? get_value()
+								 : get_value(mono_object(detail::check_field_target(get_object(i), i)));
+		}
+		return;
+	}
+
+	detail::field_target_window<GetObject> objects(count, get_object, offset_);
+	for(size_t i = 0; i < count; ++i)
+	{
+		auto address = reinterpret_cast<const char*>(objects.get(i)) + offset_;
+		if(access_ == access_mode::direct_value)
+		{
+			detail::load_field_value(out[i], address, std::integral_constant<bool, traits::by_value>{});
+		}
+		else
+		{
+			detail::load_field_reference(out[i], address, std::integral_constant<bool, traits::by_reference>{});
+		}
+	}
+}
+
+template <typename T>
+template <typename GetObject>
+void mono_field_invoker<T>::scatter_impl(size_t count, GetObject&& get_object, const T* in) const
+{
+	ensure_thread_attached();
+
+	using traits = detail::field_access_traits<T>;
+	if(access_ == access_mode::runtime || static_address_)
+	{
+		for(size_t i = 0; i < count; ++i)
+		{
+			if(is_static())
+			{
+				set_value(in[i]);
+			}
+			else
+			{
+				set_value(mono_object(detail::check_field_target(get_object(i), i)), in[i]);
+			}
+		}
+		return;
+	}
+
+	detail::field_target_window<GetObject> objects(count, get_object, offset_);
+	for(size_t i = 0; i < count; ++i)
+	{
+		auto obj = objects.get(i);
+		auto address = reinterpret_cast<char*>(obj) + offset_;
+		if(access_ == access_mode::direct_value)
+		{
+			detail::store_field_value(address, in[i], std::integral_constant<bool, traits::by_value>{});
+		}
+		else
+		{
+			detail::store_field_reference(obj, address, in[i],
+										  std::integral_constant<bool, traits::by_reference>{});
+		}
+	}
+}
+
+template <typename T>
+void mono_field_invoker<T>::gather(const mono_object* objects, size_t count, T* out) const
+{
+	gather_impl(count, [objects](size_t i) { return objects[i].get_internal_ptr(); }, out);
+}
+
+template <typename T>
+void mono_field_invoker<T>::gather(const std::vector<mono_object>& objects, T* out) const
+{
+	gather(objects.data(), objects.size(), out);
+}
+
+template <typename T>
+void mono_field_invoker<T>::gather_handles(const uint32_t* handles, size_t count, T* out) const
+{
+	gather_impl(count, [handles](size_t i) { return mono_gchandle_get_target(handles[i]); }, out);
+}
+
+template <typename T>
+void mono_field_invoker<T>::scatter(const mono_object* objects, size_t count, const T* in) const
+{
+	scatter_impl(count, [objects](size_t i) { return objects[i].get_internal_ptr(); }, in);
+}
+
+template <typename T>
+void mono_field_invoker<T>::scatter(const std::vector<mono_object>& objects, const T* in) const
+{
+	scatter(objects.data(), objects.size(), in);
+}
+
+template <typename T>
+void mono_field_invoker<T>::scatter_handles(const uint32_t* handles, size_t count, const T* in) const
+{
+	scatter_impl(count, [handles](size_t i) { return mono_gchandle_get_target(handles[i]); }, in);
+}
+
+template <typename T>
+auto mono_field_invoker<T>::get_address(const mono_object* object) const -> void*
+{
+	if(static_address_)
+	{
+		return static_address_;
+	}
+	if(!object)
+	{
+		return nullptr;
+	}
+	auto obj = object->get_internal_ptr();
+	assert(obj);
+	return reinterpret_cast<char*>(obj) + offset_;
+}
+
+template <typename T>
+auto mono_field_invoker<T>::get_owner(const mono_object* object) const -> MonoObject*
+{
+	return static_address_ || !object ? nullptr : object->get_internal_ptr();
+}
+
 template <typename T>
 void mono_field_invoker<T>::set_value(const T& val) const
 {
@@ -50,6 +410,21 @@ template <typename T>
 void mono_field_invoker<T>::set_value_impl(const mono_object* object, const T& val) const
 {
 	assert(field_);
+	ensure_thread_attached();
+
+	using traits = detail::field_access_traits<T>;
+	auto address = access_ == access_mode::runtime ? nullptr : get_address(object);
+	if(address && access_ == access_mode::direct_value)
+	{
+		detail::store_field_value(address, val, std::integral_constant<bool, traits::by_value>{});
+		return;
+	}
+	if(address)
+	{
+		detail::store_field_reference(get_owner(object), address, val,
+									  std::integral_constant<bool, traits::by_reference>{});
+		return;
+	}
 
 	auto mono_val = mono_converter<T>::to_mono(val);
 	auto arg = to_mono_arg(mono_val, type_);
@@ -71,6 +446,7 @@ inline void mono_field_invoker<mono_object>::set_value_impl(const mono_object* o
                                                              const mono_object& val) const
 {
     assert(field_);
+    ensure_thread_attached();
 
     MonoType* ftype = mono_field_get_type(field_);
     MonoClass* fklass = mono_class_from_mono_type(ftype);
@@ -88,7 +464,12 @@ inline void mono_field_invoker<mono_object>::set_value_impl(const mono_object* o
                 throw std::runtime_error("set_value(mono_object): value not assignable to reference field");
         }
 
-        if (object)
+        auto address = access_ == access_mode::runtime ? nullptr : get_address(object);
+        if (address)
+        {
+            detail::store_reference(get_owner(object), address, value_obj);
+        }
+        else if (object)
         {
             MonoObject* inst = object->get_internal_ptr();
             assert(inst);
@@ -146,6 +527,20 @@ auto mono_field_invoker<T>::get_value_impl(const mono_object* object) const -> T
 {
 	T val{};
 	assert(field_);
+	ensure_thread_attached();
+	using traits = detail::field_access_traits<T>;
+	auto address = access_ == access_mode::runtime ? nullptr : get_address(object);
+	if(address && access_ == access_mode::direct_value)
+	{
+		detail::load_field_value(val, address, std::integral_constant<bool, traits::by_value>{});
+		return val;
+	}
+	if(address)
+	{
+		detail::load_field_reference(val, address, std::integral_constant<bool, traits::by_reference>{});
+		return val;
+	}
+
 	MonoObject* refvalue = nullptr;
 	void* arg = &val;
 	if(!is_valuetype())
@@ -174,9 +569,16 @@ template <>
 inline auto mono_field_invoker<mono_object>::get_value_impl(const mono_object* object) const -> mono_object
 {
     assert(field_);
+    ensure_thread_attached();
     MonoDomain* domain = mono_domain_get();
     MonoObject* result = nullptr;
 
+	auto address = access_ == access_mode::runtime ? nullptr : get_address(object);
+	if (address)
+	{
+		return mono_object(*reinterpret_cast<MonoObject**>(address));
+	}
+
 	MonoType* ftype = mono_field_get_type(field_);
 	MonoClass* fklass = mono_class_from_mono_type(ftype);
 
@@ -0,0 +1,196 @@
+#include "mono_field_set.h"
+#include "mono_exception.h"
+#include "mono_thread.h"
+
+BEGIN_MONO_INCLUDE
+#include <mono/metadata/mono-gc.h>
+#include <mono/metadata/object.h>
+END_MONO_INCLUDE
+
+#include <algorithm>
+#include <cstring>
+
+namespace mono
+{
+
+namespace
+{
+auto align_up(size_t offset, size_t alignment) -> size_t
+{
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+auto read_handle(const char* buffer, const mono_field_set::entry& e) -> uint32_t
+{
+	uint32_t handle = 0;
+	std::memcpy(&handle, buffer + e.buffer_offset, sizeof(handle));
+	return handle;
+}
+} // namespace
+
+auto mono_field_set::get_instance_ptr(const mono_object& obj) const -> MonoObject*
+{
+	auto object = obj.get_internal_ptr();
+	// the offsets are only valid for instances of the type
+	if(!object || !mono_object_isinst(object, type_.get_internal_ptr()))
+	{
+		throw mono_exception("NATIVE::Field set needs a valid instance of class : " + type_.get_name());
+	}
+	return object;
+}
+
+mono_field_set::mono_field_set(const mono_type& type, const std::vector<std::string>& names)
+	: type_(type)
+{
+	entries_.reserve(names.size());
+	for(const auto& name : names)
+	{
+		mono_field field(type, name);
+		if(field.is_static())
+		{
+			throw mono_exception("NATIVE::Field set can't hold static field : " + name + " for class " +
+								 type.get_name());
+		}
+
+		const auto& field_type = field.get_type();
+		auto kind = field_kind::reference;
+		if(field_type.is_valuetype())
+		{
+			kind = field.is_blittable() ? field_kind::value : field_kind::value_with_references;
+		}
+		// everything the GC has to see is kept as a handle
+		size_t size = sizeof(uint32_t);
+		size_t alignment = alignof(uint32_t);
+		if(kind == field_kind::value)
+		{
+			size = field_type.get_sizeof();
+			alignment = std::max<size_t>(field_type.get_alignof(), 1);
+		}
+
+		auto buffer_offset = align_up(buffer_size_, alignment);
+		buffer_size_ = buffer_offset + size;
+		buffer_alignment_ = std::max(buffer_alignment_, alignment);
+		has_references_ = has_references_ || kind != field_kind::value;
+
+		auto object_offset = mono_field_get_offset(field.get_internal_ptr());
+		entries_.push_back(entry{field, kind, object_offset, uint32_t(buffer_offset), uint32_t(size)});
+	}
+}
+
+auto mono_field_set::get_type() const -> const mono_type&
+{
+	return type_;
+}
+
+auto mono_field_set::get_entries() const -> const std::vector<entry>&
+{
+	return entries_;
+}
+
+auto mono_field_set::get_buffer_size() const -> size_t
+{
+	return buffer_size_;
+}
+
+auto mono_field_set::get_buffer_alignment() const -> size_t
+{
+	return buffer_alignment_;
+}
+
+auto mono_field_set::has_references() const -> bool
+{
+	return has_references_;
+}
+
+void mono_field_set::snapshot(const mono_object& obj, void* buffer) const
+{
+	ensure_thread_attached();
+
+	auto object = get_instance_ptr(obj);
+	auto base = reinterpret_cast<char*>(object);
+	auto out = static_cast<char*>(buffer);
+	for(const auto& e : entries_)
+	{
+		auto address = base + e.object_offset;
+		uint32_t handle = 0;
+		switch(e.kind)
+		{
+			case field_kind::value:
+				std::memcpy(out + e.buffer_offset, address, e.size);
+				continue;
+			case field_kind::reference:
+			{
+				MonoObject* value = nullptr;
+				std::memcpy(&value, address, sizeof(value));
+				handle = value ? mono_gchandle_new(value, false) : 0;
+				break;
+			}
+			case field_kind::value_with_references:
+			{
+				// boxing copies the struct with barriers, the box then keeps
+				// what it references alive
+				auto box = mono_value_box(mono_object_get_domain(object),
+										  e.field.get_type().get_internal_ptr(), address);
+				handle = mono_gchandle_new(box, false);
+				break;
+			}
+		}
+		std::memcpy(out + e.buffer_offset, &handle, sizeof(handle));
+	}
+}
+
+void mono_field_set::restore(const mono_object& obj, const void* buffer) const
+{
+	ensure_thread_attached();
+
+	auto object = get_instance_ptr(obj);
+	auto base = reinterpret_cast<char*>(object);
+	auto in = static_cast<const char*>(buffer);
+	for(const auto& e : entries_)
+	{
+		auto address = base + e.object_offset;
+		switch(e.kind)
+		{
+			case field_kind::value:
+				std::memcpy(address, in + e.buffer_offset, e.size);
+				break;
+			case field_kind::reference:
+			{
+				auto handle = read_handle(in, e);
+				auto value = handle ? mono_gchandle_get_target(handle) : nullptr;
+				mono_gc_wbarrier_set_field(object, address, value);
+				break;
+			}
+			case field_kind::value_with_references:
+			{
+				auto box = mono_gchandle_get_target(read_handle(in, e));
+				mono_gc_wbarrier_value_copy(address, mono_object_unbox(box), 1,
+											e.field.get_type().get_internal_ptr());
+				break;
+			}
+		}
+	}
+	release(buffer);
+}
+
+void mono_field_set::release(const void* buffer) const
+{
+	if(!has_references_)
+	{
+		return;
+	}
+
+	auto in = static_cast<const char*>(buffer);
+	for(const auto& e : entries_)
+	{
+		if(e.needs_barrier())
+		{
+			if(auto handle = read_handle(in, e))
+			{
+				mono_gchandle_free(handle);
+			}
+		}
+	}
+}
+
+} // namespace mono
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "mono_config.h"
+
+#include "mono_field.h"
+#include "mono_object.h"
+
+#include <string>
+#include <vector>
+
+namespace mono
+{
+
+/// A fixed selection of instance fields of one type, copied between an
+/// object and a native buffer in one pass. Offsets, sizes and the buffer
+/// layout are computed once when the set is built; the buffer holds the
+/// fields in the order they were named, each at its natural alignment.
+class mono_field_set
+{
+public:
+	enum class field_kind
+	{
+		// copied as raw bytes
+		value,
+		// a MonoObject*, held in the buffer as a gc handle and restored
+		// through the GC write barrier
+		reference,
+		// a struct that contains references, boxed into a gc handle and
+		// restored through the value copy barrier
+		value_with_references
+	};
+
+	struct entry
+	{
+		mono_field field;
+		field_kind kind;
+		uint32_t object_offset;
+		uint32_t buffer_offset;
+		// bytes taken in the buffer, a uint32_t handle for the barrier kinds
+		uint32_t size;
+
+		/// True if the buffer holds a gc handle and restoring this field must
+		/// go through a GC barrier.
+		auto needs_barrier() const -> bool
+		{
+			return kind != field_kind::value;
+		}
+	};
+
+	/// Fields are looked up like mono_field does, base classes included.
+	/// Throws mono_exception for missing or static fields.
+	explicit mono_field_set(const mono_type& type, const std::vector<std::string>& names);
+
+	auto get_type() const -> const mono_type&;
+
+	auto get_entries() const -> const std::vector<entry>&;
+
+	/// Bytes the buffer passed to snapshot/restore must hold.
+	auto get_buffer_size() const -> size_t;
+
+	/// Alignment the buffer must have, the largest field alignment.
+	auto get_buffer_alignment() const -> size_t;
+
+	/// True if any field needs a GC barrier on restore.
+	auto has_references() const -> bool;
+
+	/// Copies every field of obj into buffer.
+	/// Throws mono_exception if obj is not an instance of the type.
+	/// The GC doesn't scan the buffer, so references (and structs holding
+	/// them, boxed) are kept as gc handles, which follow the objects when a
+	/// collection moves them. Pass the buffer to restore() or release()
+	/// exactly once to free them.
+	void snapshot(const mono_object& obj, void* buffer) const;
+
+	/// Writes every field from buffer back into obj and frees the handles
+	/// taken by snapshot(), so a snapshot can be restored only once.
+	/// Throws mono_exception if obj is not an instance of the type, the
+	/// buffer is left untouched then.
+	void restore(const mono_object& obj, const void* buffer) const;
+
+	/// Frees the handles of a snapshot that won't be restored.
+	void release(const void* buffer) const;
+
+private:
+	auto get_instance_ptr(const mono_object& obj) const -> MonoObject*;
+
+	mono_type type_;
+
+	std::vector<entry> entries_;
+
+	size_t buffer_size_ = 0;
+
+	size_t buffer_alignment_ = 1;
+
+	bool has_references_ = false;
+};
+
+} // namespace mono
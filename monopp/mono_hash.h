@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mono
+{
+
+namespace detail
+{
+// Reflected CRC-64 with the ECMA-182 polynomial, zero init and no final xor.
+constexpr std::uint64_t crc64_poly = 0xc96c5795d7870f42ull;
+
+struct crc64_tables_t
+{
+	// t[k][b] is the crc of byte b followed by k zero bytes
+	std::uint64_t t[8][256];
+};
+
+constexpr auto make_crc64_tables() -> crc64_tables_t
+{
+	crc64_tables_t tables{};
+	for(std::uint64_t i = 0; i < 256; ++i)
+	{
+		auto crc = i;
+		for(int bit = 0; bit < 8; ++bit)
+		{
+			crc = (crc >> 1) ^ ((crc & 1) ? crc64_poly : 0);
+		}
+		tables.t[0][i] = crc;
+	}
+	for(std::size_t k = 1; k < 8; ++k)
+	{
+		for(std::size_t i = 0; i < 256; ++i)
+		{
+			auto prev = tables.t[k - 1][i];
+			tables.t[k][i] = (prev >> 8) ^ tables.t[0][prev & 0xff];
+		}
+	}
+	return tables;
+}
+
+// a class template so the tables can be defined in the header
+template <typename T = void>
+struct crc64_tables
+{
+	static constexpr crc64_tables_t value = make_crc64_tables();
+};
+
+template <typename T>
+constexpr crc64_tables_t crc64_tables<T>::value;
+
+constexpr auto load_le64(const char* p) -> std::uint64_t
+{
+	// compilers fold this into a single load on little endian targets
+	return std::uint64_t(std::uint8_t(p[0])) | std::uint64_t(std::uint8_t(p[1])) << 8 |
+		   std::uint64_t(std::uint8_t(p[2])) << 16 | std::uint64_t(std::uint8_t(p[3])) << 24 |
+		   std::uint64_t(std::uint8_t(p[4])) << 32 | std::uint64_t(std::uint8_t(p[5])) << 40 |
+		   std::uint64_t(std::uint8_t(p[6])) << 48 | std::uint64_t(std::uint8_t(p[7])) << 56;
+}
+
+constexpr auto const_strlen(const char* str) -> std::size_t
+{
+	std::size_t size = 0;
+	while(str[size] != 0)
+	{
+		++size;
+	}
+	return size;
+}
+
+} // namespace detail
+
+/// Slicing-by-8 CRC-64, usable in constant expressions.
+constexpr auto crc64(const char* data, std::size_t size) -> std::uint64_t
+{
+	const auto& t = detail::crc64_tables<>::value.t;
+	std::uint64_t crc = 0;
+	std::size_t i = 0;
+	for(; i + 8 <= size; i += 8)
+	{
+		crc ^= detail::load_le64(data + i);
+		crc = t[7][crc & 0xff] ^ t[6][(crc >> 8) & 0xff] ^ t[5][(crc >> 16) & 0xff] ^
+			  t[4][(crc >> 24) & 0xff] ^ t[3][(crc >> 32) & 0xff] ^ t[2][(crc >> 40) & 0xff] ^
+			  t[1][(crc >> 48) & 0xff] ^ t[0][crc >> 56];
+	}
+	for(; i < size; ++i)
+	{
+		crc = (crc >> 8) ^ t[0][(crc ^ std::uint8_t(data[i])) & 0xff];
+	}
+	return crc;
+}
+
+constexpr auto crc64(const char* data) -> std::uint64_t
+{
+	return crc64(data, detail::const_strlen(data));
+}
+
+} // namespace mono
@@ -2,6 +2,7 @@
 #include "mono_assembly.h"
 #include "mono_exception.h"
 #include "mono_logger.h"
+#include "mono_thread.h"
 
 BEGIN_MONO_INCLUDE
 #include <mono/jit/jit.h>
@@ -272,6 +273,8 @@ auto get_core_assembly_path() -> std::string
 
 void shutdown()
 {
+	shutdown_thread_attachments();
+
 	if(jit_domain)
 	{
 		mono_jit_cleanup(jit_domain);
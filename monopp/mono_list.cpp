@@ -1,9 +1,81 @@
 #include "mono_list.h"
 #include "mono_domain.h"
+#include "mono_meta_cache.h"
 #include "mono_method_invoker.h"
 #include "mono_property_invoker.h"
 
 namespace mono
 {
 
+namespace
+{
+
+auto get_list_cache() -> mono_meta_cache<MonoClass*, lazy_value<detail::list_layout>>&
+{
+	static mono_meta_cache<MonoClass*, lazy_value<detail::list_layout>> list_cache;
+	return list_cache;
+}
+
+// The List<T> a class is or derives from, nullptr if there is none.
+auto find_list_class(MonoClass* cls) -> MonoClass*
+{
+	auto corlib = mono_get_corlib();
+	for(; cls; cls = mono_class_get_parent(cls))
+	{
+		if(mono_class_get_image(cls) == corlib && std::strcmp(mono_class_get_name(cls), "List`1") == 0 &&
+		   std::strcmp(mono_class_get_namespace(cls), "System.Collections.Generic") == 0)
+		{
+			return cls;
+		}
+	}
+	return nullptr;
+}
+
+auto build_list_layout(MonoClass* cls) -> detail::list_layout
+{
+	detail::list_layout layout;
+	auto list_class = find_list_class(cls);
+	if(!list_class)
+	{
+		return layout;
+	}
+	auto items = mono_class_get_field_from_name(list_class, "_items");
+	auto size = mono_class_get_field_from_name(list_class, "_size");
+	if(!items || !size)
+	{
+		return layout;
+	}
+
+	auto element_class = mono_class_get_element_class(mono_class_from_mono_type(mono_field_get_type(items)));
+	mono_type element_type(element_class);
+	layout.element_is_reference = !element_type.is_valuetype();
+	layout.element_is_blittable = element_type.is_blittable();
+	layout.element_size = std::uint32_t(mono_class_array_element_size(element_class));
+	layout.items_offset = mono_field_get_offset(items);
+	layout.size_offset = mono_field_get_offset(size);
+	if(auto version = mono_class_get_field_from_name(list_class, "_version"))
+	{
+		layout.has_version = true;
+		layout.version_offset = mono_field_get_offset(version);
+	}
+	layout.valid = true;
+	return layout;
+}
+
+} // namespace
+
+namespace detail
+{
+auto get_list_layout(MonoClass* list_class) -> const list_layout&
+{
+	auto& layout = get_list_cache().find_or_emplace(list_class);
+	return layout.get([list_class]() { return build_list_layout(list_class); });
+}
+} // namespace detail
+
+void reset_list_cache()
+{
+	get_list_cache().clear();
+}
+
 } // namespace mono
@@ -9,7 +9,9 @@
 #include "mono_method_invoker.h"
 #include "mono_property_invoker.h"
 #include "mono_array.h"
+#include "mono_thread.h"
 
+#include <algorithm>
 #include <cstring>
 #include <list>
 #include <memory>
@@ -19,6 +21,27 @@
 namespace mono
 {
 
+namespace detail
+{
+/// Where a List<T> keeps its elements, resolved once per List<T> class.
+struct list_layout
+{
+	// false for classes that aren't a List<T>, these go through the methods
+	bool valid = false;
+	bool has_version = false;
+	bool element_is_reference = false;
+	bool element_is_blittable = false;
+	uint32_t items_offset = 0;
+	uint32_t size_offset = 0;
+	uint32_t version_offset = 0;
+	uint32_t element_size = 0;
+};
+
+auto get_list_layout(MonoClass* list_class) -> const list_layout&;
+} // namespace detail
+
+void reset_list_cache();
+
 //------------------------------------------------------------------------------
 // A lightweight base for wrapping System.Collections.Generic.List<T> objects
 //------------------------------------------------------------------------------
@@ -30,9 +53,16 @@ public:
 	{
 	}
 
-	// Get the 'Count' property by invoking 'get_Count'
+	// Get the 'Count' property, read from '_size' for a List<T>
 	auto size() const -> std::size_t
 	{
+		const auto& layout = get_layout();
+		if(layout.valid)
+		{
+			return static_cast<std::size_t>(
+				*reinterpret_cast<const int32_t*>(reinterpret_cast<const char*>(object_) + layout.size_offset));
+		}
+
 		MonoObject* exc = nullptr;
 		MonoObject* result = invoke_method("get_Count", nullptr, 0, &exc);
 		if(exc)
@@ -67,6 +97,56 @@ public:
 	}
 
 protected:
+	// Throws mono_exception for an invalid list, every element access goes through here.
+	auto get_layout() const -> const detail::list_layout&
+	{
+		if(!object_)
+		{
+			throw mono_exception("NATIVE::Accessing an invalid List<T>");
+		}
+		ensure_thread_attached();
+		return detail::get_list_layout(mono_object_get_class(object_));
+	}
+
+	// The backing '_items' array, whose length is the capacity, not the size.
+	auto get_items(const detail::list_layout& layout) const -> MonoArray*
+	{
+		return *reinterpret_cast<MonoArray* const*>(reinterpret_cast<const char*>(object_) + layout.items_offset);
+	}
+
+	// Grows '_items' with a single call to set_Capacity. Doubles at least,
+	// like List<T>.Add does, so repeated appends stay amortized.
+	void grow_capacity(const detail::list_layout& layout, std::size_t required)
+	{
+		auto capacity = static_cast<std::size_t>(mono_array_length(get_items(layout)));
+		if(capacity >= required)
+		{
+			return;
+		}
+
+		auto new_capacity = static_cast<int32_t>(std::max(required, capacity * 2));
+		void* args[1] = {&new_capacity};
+		MonoObject* exc = nullptr;
+		invoke_method("set_Capacity", args, 1, &exc);
+		if(exc)
+			throw mono_thunk_exception(exc);
+	}
+
+	void set_size(const detail::list_layout& layout, std::size_t size)
+	{
+		*reinterpret_cast<int32_t*>(reinterpret_cast<char*>(object_) + layout.size_offset) =
+			static_cast<int32_t>(size);
+	}
+
+	// Invalidates enumerators, like every List<T> mutation does.
+	void bump_version(const detail::list_layout& layout)
+	{
+		if(layout.has_version)
+		{
+			++*reinterpret_cast<int32_t*>(reinterpret_cast<char*>(object_) + layout.version_offset);
+		}
+	}
+
 	// Helper: invoke a method on 'this' object by name (naive approach)
 	auto invoke_method(const char* methodName, void** params, int /*paramCount*/, MonoObject** exc) const
 		-> MonoObject*
@@ -74,6 +154,7 @@ protected:
 		if(!object_)
 			return nullptr;
 
+		ensure_thread_attached();
 		MonoClass* klass = mono_object_get_class(object_);
 		void* iter = nullptr;
 		MonoMethod* targetMethod = nullptr;
@@ -114,37 +195,31 @@ public:
 	{
 	}
 
-	auto create_list(const mono_domain& domain, const mono_type& type) -> mono_object
+	// Static, it runs before the base is constructed. Throws mono_exception
+	// when List<T> can't be made for the element type.
+	static auto create_list(const mono_domain& domain, const mono_type& type) -> mono_object
 	{
 		mono_type list_class(get_list_class_for_type(type));
-		if(list_class.valid())
+		if(!list_class.valid())
 		{
-			return list_class.new_instance(domain);
-		}
-		else
-		{
-			return {};
+			throw mono_exception("NATIVE::Could not create a List<T> for element type : " +
+								 (type.valid() ? type.get_fullname() : std::string("<deduced from T>")));
 		}
+		return list_class.new_instance(domain);
 	}
 
 	template<typename VectorLike = std::vector<T>>
 	mono_list(const VectorLike& vec)
-		: mono_list_base(create_list(mono_domain::get_current_domain(), vec.size(), {}))
+		: mono_list_base(create_list(mono_domain::get_current_domain(), {}))
 	{
-		for(auto& item : vec)
-		{
-			add(item);
-		}
+		add_range(vec);
 	}
 
 	template<typename VectorLike = std::vector<T>>
 	mono_list(const VectorLike& vec, const mono_type& element_type)
 		: mono_list_base(create_list(mono_domain::get_current_domain(), element_type))
 	{
-		for(auto& item : vec)
-		{
-			add(item);
-		}
+		add_range(vec);
 	}
 
 	template<typename VectorLike = std::vector<T>>
@@ -156,18 +231,14 @@ public:
 		}
 
 		clear();
-		for(auto& item : vec)
+		if(create_missing_elements)
 		{
-			auto item_to_add = item;
-			if(create_missing_elements && !item_to_add.valid())
-			{
-				item_to_add = element_type.new_instance();
-			}
-			add(item_to_add);
+			auto items = vec;
+			create_missing_elements_in(items, element_type, std::is_base_of<mono_object, T>{});
+			add_range(items);
+			return;
 		}
-
-		auto new_vector = to_vector<VectorLike>();
-		(void)new_vector;
+		add_range(vec);
 	}
 
 	void add()
@@ -187,9 +258,43 @@ public:
 		invoker(*this, value);
 	}
 
+	// Add all items to the end of the list (List<T>.AddRange). A List<T>
+	// grows its capacity once and the items are written straight into '_items'.
+	template<typename VectorLike = std::vector<T>>
+	void add_range(const VectorLike& vec)
+	{
+		if(vec.size() == 0)
+		{
+			return;
+		}
+
+		const auto& layout = get_layout();
+		if(can_access_directly(layout))
+		{
+			auto first = size();
+			grow_capacity(layout, first + vec.size());
+			write_elements(layout, first, vec, is_contiguous_vector<VectorLike>{});
+			set_size(layout, first + vec.size());
+			bump_version(layout);
+			return;
+		}
+
+		auto invoker = make_method_invoker<void(const T&)>(get_type(), "Add");
+		for(auto& item : vec)
+		{
+			invoker(*this, item);
+		}
+	}
+
 	// Retrieve an element by index (List<T>.get_Item)
 	auto get(std::size_t index) const -> T
 	{
+		const auto& layout = get_layout();
+		if(can_access_directly(layout) && index < size())
+		{
+			return read_element(layout, get_items(layout), index);
+		}
+
 		int idx = static_cast<int>(index);
 		auto invoker = make_property_invoker<T>(get_type(), "Item");
 		return invoker.get_value_with_args(*this, idx);
@@ -198,6 +303,14 @@ public:
 	// Set an element by index (List<T>.set_Item)
 	void set(std::size_t index, const T& value)
 	{
+		const auto& layout = get_layout();
+		if(can_access_directly(layout) && index < size())
+		{
+			write_element(layout, get_items(layout), index, value);
+			bump_version(layout);
+			return;
+		}
+
 		int idx = static_cast<int>(index);
 		auto invoker = make_property_invoker<T>(get_type(), "Item");
 		invoker.set_value_with_args(*this, idx, value);
@@ -208,6 +321,16 @@ public:
 	{
 		std::list<T> result;
 		std::size_t n = size();
+		const auto& layout = get_layout();
+		if(can_access_directly(layout))
+		{
+			auto items = get_items(layout);
+			for(std::size_t i = 0; i < n; i++)
+			{
+				result.push_back(read_element(layout, items, i));
+			}
+			return result;
+		}
 		for(std::size_t i = 0; i < n; i++)
 		{
 			result.push_back(get(i));
@@ -218,16 +341,21 @@ public:
 	template<typename VectorLike = std::vector<T>>
 	auto to_vector() const -> VectorLike
 	{
-		auto element_type = get_element_type();
-		VectorLike vec(size());
-		for(size_t i = 0; i < size(); ++i)
+		auto n = size();
+		VectorLike vec(n);
+		const auto& layout = get_layout();
+		if(can_access_directly(layout))
 		{
-			vec[i] = get(i);
-			if(!vec[i].get_type().valid())
+			read_elements(layout, vec, n, is_contiguous_vector<VectorLike>{});
+		}
+		else
+		{
+			for(size_t i = 0; i < n; ++i)
 			{
-				vec[i] = mono_object(nullptr, element_type);
+				vec[i] = get(i);
 			}
 		}
+		type_null_elements(vec, n, std::is_base_of<mono_object, T>{});
 		return vec;
 	}
 
@@ -238,6 +366,144 @@ public:
 	}
 
 private:
+	using traits = detail::field_access_traits<T>;
+
+	template <typename VectorLike>
+	using is_contiguous_vector =
+		std::integral_constant<bool, traits::by_value && std::is_same<VectorLike, std::vector<T>>::value &&
+										 !std::is_same<T, bool>::value>;
+
+	// True if T can be read and written straight from the '_items' array
+	auto can_access_directly(const detail::list_layout& layout) const -> bool
+	{
+		if(!layout.valid)
+		{
+			return false;
+		}
+		if(layout.element_is_reference)
+		{
+			return traits::by_reference;
+		}
+		return traits::by_value && layout.element_is_blittable && layout.element_size == sizeof(T);
+	}
+
+	static auto read_element(const detail::list_layout& layout, MonoArray* items, std::size_t index) -> T
+	{
+		T value{};
+		auto address = mono_array_addr_with_size(items, int(layout.element_size), index);
+		if(layout.element_is_reference)
+		{
+			detail::load_field_reference(value, address, std::integral_constant<bool, traits::by_reference>{});
+		}
+		else
+		{
+			detail::load_field_value(value, address, std::integral_constant<bool, traits::by_value>{});
+		}
+		return value;
+	}
+
+	static void write_element(const detail::list_layout& layout, MonoArray* items, std::size_t index,
+							  const T& value)
+	{
+		auto address = mono_array_addr_with_size(items, int(layout.element_size), index);
+		if(layout.element_is_reference)
+		{
+			// the array is the object that holds the reference
+			detail::store_field_reference(reinterpret_cast<MonoObject*>(items), address, value,
+										  std::integral_constant<bool, traits::by_reference>{});
+		}
+		else
+		{
+			detail::store_field_value(address, value, std::integral_constant<bool, traits::by_value>{});
+		}
+	}
+
+	// A std::vector of blittable values is filled with a single copy
+	template <typename VectorLike>
+	void read_elements(const detail::list_layout& layout, VectorLike& vec, std::size_t n, std::true_type) const
+	{
+		if(!layout.element_is_reference && n > 0)
+		{
+			std::memcpy(vec.data(), mono_array_addr_with_size(get_items(layout), int(sizeof(T)), 0),
+						n * sizeof(T));
+			return;
+		}
+		read_elements(layout, vec, n, std::false_type{});
+	}
+
+	template <typename VectorLike>
+	void read_elements(const detail::list_layout& layout, VectorLike& vec, std::size_t n, std::false_type) const
+	{
+		auto items = get_items(layout);
+		for(std::size_t i = 0; i < n; ++i)
+		{
+			vec[i] = read_element(layout, items, i);
+		}
+	}
+
+	// A std::vector of blittable values is stored with a single copy
+	template <typename VectorLike>
+	void write_elements(const detail::list_layout& layout, std::size_t first, const VectorLike& vec,
+						std::true_type)
+	{
+		if(!layout.element_is_reference)
+		{
+			std::memcpy(mono_array_addr_with_size(get_items(layout), int(sizeof(T)), first), vec.data(),
+						vec.size() * sizeof(T));
+			return;
+		}
+		write_elements(layout, first, vec, std::false_type{});
+	}
+
+	template <typename VectorLike>
+	void write_elements(const detail::list_layout& layout, std::size_t first, const VectorLike& vec,
+						std::false_type)
+	{
+		auto items = get_items(layout);
+		auto index = first;
+		for(auto& item : vec)
+		{
+			write_element(layout, items, index++, item);
+		}
+	}
+
+	template <typename VectorLike>
+	static void create_missing_elements_in(VectorLike& vec, const mono_type& element_type, std::true_type)
+	{
+		for(auto& item : vec)
+		{
+			if(!item.valid())
+			{
+				item = element_type.new_instance();
+			}
+		}
+	}
+
+	// Values are never missing
+	template <typename VectorLike>
+	static void create_missing_elements_in(VectorLike&, const mono_type&, std::false_type)
+	{
+	}
+
+	// Null references keep the element type, so they can still be inspected
+	template <typename VectorLike>
+	void type_null_elements(VectorLike& vec, std::size_t n, std::true_type) const
+	{
+		auto element_type = get_element_type();
+		for(std::size_t i = 0; i < n; ++i)
+		{
+			if(!vec[i].get_type().valid())
+			{
+				vec[i] = mono_object(nullptr, element_type);
+			}
+		}
+	}
+
+	template <typename VectorLike>
+	void type_null_elements(VectorLike&, std::size_t, std::false_type) const
+	{
+	}
+
 	// Helper to get MonoClass for T without if constexpr
 	static auto mono_class_from_element_type() -> MonoClass*
 	{
@@ -366,9 +632,6 @@ private:
 		// 	return nullptr;
 
 		// 4) Create a MonoGenericInst that holds our single type argument (int)
-		MonoType* typeArgs[1];
-		typeArgs[0] = elementMonoType;
-
 		struct _MonoGenericInst
 		{
 			uint32_t id;			 /* unique ID for debugging */
@@ -440,10 +703,7 @@ struct mono_converter<mono_list<T>>
 
 	static auto from_mono(const managed_type& obj) -> native_type
 	{
-		if(!obj)
-		{
-			return {};
-		}
+		// null maps to an invalid list, not to a new one
 		return mono_list<T>(mono_object(obj));
 	}
 };
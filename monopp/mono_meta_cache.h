@@ -0,0 +1,412 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mono
+{
+
+namespace detail
+{
+/// Serial numbers of the live mono_domains. A cache generation retired
+/// while some domains were alive may be referenced by their wrappers, so it
+/// is kept until all of them are unloaded.
+struct domain_epochs
+{
+	std::mutex mutex;
+	std::uint64_t last = 0;
+	std::vector<std::uint64_t> live;
+};
+
+inline auto get_domain_epochs() -> domain_epochs&
+{
+	static domain_epochs epochs;
+	return epochs;
+}
+
+/// Called by a mono_domain when it is created, returns its serial number.
+inline auto enter_domain_epoch() -> std::uint64_t
+{
+	auto& epochs = get_domain_epochs();
+	std::lock_guard<std::mutex> lock(epochs.mutex);
+	epochs.live.push_back(++epochs.last);
+	return epochs.last;
+}
+
+/// Called by a mono_domain when it is unloaded.
+inline void leave_domain_epoch(std::uint64_t serial)
+{
+	auto& epochs = get_domain_epochs();
+	std::lock_guard<std::mutex> lock(epochs.mutex);
+	epochs.live.erase(std::remove(epochs.live.begin(), epochs.live.end(), serial), epochs.live.end());
+}
+
+/// The serial of the newest domain created so far.
+inline auto get_domain_epoch() -> std::uint64_t
+{
+	auto& epochs = get_domain_epochs();
+	std::lock_guard<std::mutex> lock(epochs.mutex);
+	return epochs.last;
+}
+
+/// The serial of the oldest live domain, max() if there is none.
+inline auto get_oldest_domain_epoch() -> std::uint64_t
+{
+	auto& epochs = get_domain_epochs();
+	std::lock_guard<std::mutex> lock(epochs.mutex);
+	return epochs.live.empty() ? std::numeric_limits<std::uint64_t>::max()
+							   : *std::min_element(epochs.live.begin(), epochs.live.end());
+}
+
+/// Every mono_meta_cache registers itself, so that a domain unload can
+/// retire all of them at once.
+class meta_cache_base
+{
+public:
+	virtual void retire() = 0;
+
+protected:
+	meta_cache_base();
+	~meta_cache_base();
+
+	/// Called by the derived destructor, before retire() stops being callable.
+	void unregister();
+};
+
+struct meta_cache_registry
+{
+	std::mutex mutex;
+	std::vector<meta_cache_base*> caches;
+};
+
+inline auto get_meta_cache_registry() -> meta_cache_registry&
+{
+	static meta_cache_registry registry;
+	return registry;
+}
+
+inline meta_cache_base::meta_cache_base()
+{
+	auto& registry = get_meta_cache_registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.caches.push_back(this);
+}
+
+inline meta_cache_base::~meta_cache_base()
+{
+	unregister();
+}
+
+inline void meta_cache_base::unregister()
+{
+	auto& registry = get_meta_cache_registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.caches.erase(std::remove(registry.caches.begin(), registry.caches.end(), this),
+						  registry.caches.end());
+}
+
+/// Retires the contents of every cache, see mono_meta_cache::retire().
+inline void retire_meta_caches()
+{
+	auto& registry = get_meta_cache_registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	for(auto cache : registry.caches)
+	{
+		cache->retire();
+	}
+}
+} // namespace detail
+
+/// Insert-only hash map for read-mostly metadata caches.
+/// Values live in an arena (a deque of nodes) and keep their address until
+/// clear() or until a retired generation is freed, so callers can hold plain
+/// pointers to them.
+/// Lookups are lock free: an open addressing table of atomic node pointers
+/// that is only ever appended to. Inserts take a mutex and grow the table
+/// by publishing a bigger copy; older tables are kept alive as well, so a
+/// reader racing with a grow or a retire() still probes valid memory and at
+/// worst misses, falling back to insert() which re-checks under the lock.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class mono_meta_cache : public detail::meta_cache_base
+{
+public:
+	mono_meta_cache()
+	{
+		reset_table();
+	}
+
+	~mono_meta_cache()
+	{
+		unregister();
+	}
+
+	mono_meta_cache(const mono_meta_cache&) = delete;
+	auto operator=(const mono_meta_cache&) -> mono_meta_cache& = delete;
+
+	/// Returns the cached value or nullptr. Never blocks.
+	auto find(const Key& key) -> Value*
+	{
+		auto n = find_node(*table_.load(std::memory_order_acquire), key);
+		return n ? &n->value : nullptr;
+	}
+
+	/// Constructs the value in place if the key is not cached yet and returns
+	/// the cached value, which is the existing one when another thread got
+	/// there first.
+	template <typename... Args>
+	auto emplace(const Key& key, Args&&... args) -> Value&
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto current = table_.load(std::memory_order_relaxed);
+		if(auto existing = find_node(*current, key))
+		{
+			return existing->value;
+		}
+
+		if((size_ + 1) * 2 > current->capacity)
+		{
+			current = grow(*current);
+		}
+
+		nodes_.emplace_back(key, std::forward<Args>(args)...);
+		auto n = &nodes_.back();
+		place(*current, n);
+		size_++;
+		return n->value;
+	}
+
+	/// Lock free when cached, otherwise default constructs the value.
+	auto find_or_emplace(const Key& key) -> Value&
+	{
+		if(auto value = find(key))
+		{
+			return *value;
+		}
+		return emplace(key);
+	}
+
+	/// Starts over with an empty cache and frees every value, retired ones
+	/// included. Pointers to them are invalid afterwards and no other thread
+	/// may use the cache meanwhile.
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		retired_.clear();
+		if(size_ == 0)
+		{
+			return;
+		}
+
+		nodes_.clear();
+		size_ = 0;
+		tables_.clear();
+		reset_table();
+	}
+
+	/// Starts over with an empty cache when a domain unloads. The values are
+	/// kept until every domain that was alive by then is unloaded as well,
+	/// since wrappers of those domains may still point at them. Generations
+	/// retired earlier whose domains are all gone are freed.
+	void retire() override
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto oldest = detail::get_oldest_domain_epoch();
+		if(size_ != 0)
+		{
+			retired_.emplace_back();
+			auto& retired = retired_.back();
+			retired.epoch = detail::get_domain_epoch();
+			// swapping keeps the nodes where they are
+			retired.tables.swap(tables_);
+			retired.nodes.swap(nodes_);
+			size_ = 0;
+			reset_table();
+		}
+
+		retired_.remove_if([oldest](const generation& g) { return g.epoch < oldest; });
+	}
+
+	/// Generations retired but not freed yet.
+	auto retired_count() const -> std::size_t
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return retired_.size();
+	}
+
+	/// Calls f(key, value) for every cached value, under the insert lock,
+	/// so f must not insert into this cache.
+	template <typename F>
+	void for_each(F&& f) const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for(const auto& n : nodes_)
+		{
+			f(n.key, n.value);
+		}
+	}
+
+	auto size() const -> std::size_t
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return size_;
+	}
+
+private:
+	static constexpr std::size_t initial_capacity = 64;
+
+	struct node
+	{
+		template <typename... Args>
+		explicit node(const Key& k, Args&&... args)
+			: key(k)
+			, value(std::forward<Args>(args)...)
+		{
+		}
+
+		Key key;
+		Value value;
+	};
+
+	struct table
+	{
+		explicit table(std::size_t cap)
+			: capacity(cap)
+			, slots(new std::atomic<node*>[cap])
+		{
+			for(std::size_t i = 0; i < capacity; ++i)
+			{
+				slots[i].store(nullptr, std::memory_order_relaxed);
+			}
+		}
+
+		std::size_t capacity;
+		std::unique_ptr<std::atomic<node*>[]> slots;
+	};
+
+	static auto slot_index(const table& t, const Key& key) -> std::size_t
+	{
+		// spread pointer-like hashes whose low bits are always zero
+		auto h = std::uint64_t(Hash()(key)) * 0x9e3779b97f4a7c15ull;
+		return std::size_t(h >> 32) & (t.capacity - 1);
+	}
+
+	static auto find_node(const table& t, const Key& key) -> node*
+	{
+		auto i = slot_index(t, key);
+		for(;;)
+		{
+			auto n = t.slots[i].load(std::memory_order_acquire);
+			if(!n)
+			{
+				return nullptr;
+			}
+			if(n->key == key)
+			{
+				return n;
+			}
+			i = (i + 1) & (t.capacity - 1);
+		}
+	}
+
+	static void place(table& t, node* n)
+	{
+		auto i = slot_index(t, n->key);
+		while(t.slots[i].load(std::memory_order_relaxed))
+		{
+			i = (i + 1) & (t.capacity - 1);
+		}
+		t.slots[i].store(n, std::memory_order_release);
+	}
+
+	auto grow(const table& current) -> table*
+	{
+		tables_.emplace_back(new table(current.capacity * 2));
+		auto bigger = tables_.back().get();
+		for(auto& n : nodes_)
+		{
+			place(*bigger, &n);
+		}
+		table_.store(bigger, std::memory_order_release);
+		return bigger;
+	}
+
+	void reset_table()
+	{
+		tables_.emplace_back(new table(initial_capacity));
+		table_.store(tables_.back().get(), std::memory_order_release);
+	}
+
+	std::atomic<table*> table_{nullptr};
+	/// The current table and the ones it replaced.
+	std::vector<std::unique_ptr<table>> tables_;
+	std::deque<node> nodes_;
+	std::size_t size_ = 0;
+
+	struct generation
+	{
+		// the newest domain alive when it was retired
+		std::uint64_t epoch = 0;
+		std::vector<std::unique_ptr<table>> tables;
+		std::deque<node> nodes;
+	};
+	std::list<generation> retired_;
+
+	mutable std::mutex mutex_;
+};
+
+inline auto get_lazy_value_mutex() -> std::recursive_mutex&
+{
+	// only taken the first time a value is computed; recursive because
+	// computing one value may read another (e.g. full_declname -> fullname)
+	static std::recursive_mutex mutex;
+	return mutex;
+}
+
+/// A meta_info attribute computed on first access, exactly once even when
+/// several threads ask for it at the same time. Reads after that are a
+/// single acquire load.
+template <typename T>
+class lazy_value
+{
+public:
+	template <typename F>
+	auto get(F&& compute) const -> const T&
+	{
+		if(!ready_.load(std::memory_order_acquire))
+		{
+			std::lock_guard<std::recursive_mutex> lock(get_lazy_value_mutex());
+			if(!ready_.load(std::memory_order_relaxed))
+			{
+				value_ = compute();
+				ready_.store(true, std::memory_order_release);
+			}
+		}
+		return value_;
+	}
+
+	auto is_ready() const -> bool
+	{
+		return ready_.load(std::memory_order_acquire);
+	}
+
+	/// The value if it was computed already, nullptr otherwise.
+	auto get_if_ready() const -> const T*
+	{
+		return is_ready() ? &value_ : nullptr;
+	}
+
+private:
+	mutable T value_{};
+	mutable std::atomic<bool> ready_{false};
+};
+
+} // namespace mono
@@ -1,8 +1,12 @@
 #include "mono_method.h"
+#include "mono_assembly.h"
+#include "mono_attributes.h"
 #include "mono_exception.h"
+#include "mono_meta_cache.h"
+#include "mono_object.h"
 #include "mono_type.h"
 
-#include <unordered_map>
+#include <cstring>
 
 BEGIN_MONO_INCLUDE
 #include <mono/metadata/appdomain.h>
@@ -14,35 +18,73 @@ namespace mono
 {
 struct mono_method::meta_info
 {
-	std::string name;
-	std::string fullname;
-	std::string full_declname;
+	lazy_value<std::string> name;
+	lazy_value<std::string> fullname;
+	lazy_value<std::string> full_declname;
+	lazy_value<std::vector<MonoClass*>> attribute_classes;
 };
 
 namespace
 {
 
-auto get_method_cache() -> std::unordered_map<MonoMethod*, std::shared_ptr<mono_method::meta_info>>&
+auto get_method_cache() -> mono_meta_cache<MonoMethod*, mono_method::meta_info>&
 {
-	static std::unordered_map<MonoMethod*, std::shared_ptr<mono_method::meta_info>> method_cache;
+	static mono_meta_cache<MonoMethod*, mono_method::meta_info> method_cache;
 	return method_cache;
 }
 
-auto get_meta_info(MonoMethod* method) -> std::shared_ptr<mono_method::meta_info>
+auto get_meta_info(MonoMethod* method) -> mono_method::meta_info*
 {
 	auto& cache = get_method_cache();
-	auto it = cache.find(method);
-	if(it != cache.end())
+	return &cache.find_or_emplace(method);
+}
+
+struct method_resolution_key
+{
+	MonoClass* cls = nullptr;
+	size_t name_hash = 0;
+	size_t signature_id = 0;
+
+	auto operator==(const method_resolution_key& rhs) const -> bool
+	{
+		return cls == rhs.cls && name_hash == rhs.name_hash && signature_id == rhs.signature_id;
+	}
+};
+
+struct method_resolution_key_hasher
+{
+	auto operator()(const method_resolution_key& key) const -> size_t
 	{
-		return it->second;
+		size_t seed = std::hash<MonoClass*>()(key.cls);
+		seed ^= key.name_hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		seed ^= key.signature_id + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		return seed;
 	}
-	return nullptr;
+};
+
+auto get_method_resolution_cache()
+	-> mono_meta_cache<method_resolution_key, mono_method, method_resolution_key_hasher>&
+{
+	static mono_meta_cache<method_resolution_key, mono_method, method_resolution_key_hasher> resolution_cache;
+	return resolution_cache;
 }
 
-void set_meta_info(MonoMethod* method, std::shared_ptr<mono_method::meta_info> meta)
+// Like mono_class_get_method_from_name, but a class recorded in the metadata
+// snapshot is searched by its recorded names, without loading its methods.
+auto get_method_from_name(MonoClass* cls, const std::string& name, int argc) -> MonoMethod*
 {
-	auto& cache = get_method_cache();
-	cache[method] = meta;
+	if(auto members = detail::find_snapshot_members(cls))
+	{
+		for(const auto& method : members->methods)
+		{
+			if(method.name == name && (argc < 0 || method.param_count == argc))
+			{
+				return mono_get_method(mono_class_get_image(cls), method.token, cls);
+			}
+		}
+		return nullptr;
+	}
+	return mono_class_get_method_from_name(cls, name.c_str(), argc);
 }
 
 } // namespace
@@ -86,7 +128,7 @@ mono_method::mono_method(const mono_type& type, const std::string& name, int arg
 	auto check_type = type;
 	while(!method_ && check_type.valid())
 	{
-		method_ = mono_class_get_method_from_name(check_type.get_internal_ptr(), name.c_str(), argc);
+		method_ = get_method_from_name(check_type.get_internal_ptr(), name, argc);
 		check_type = check_type.get_base_type();
 	}
 
@@ -107,17 +149,18 @@ auto mono_method::get_internal_ptr() const -> MonoMethod*
 
 void mono_method::generate_meta()
 {
-	auto meta = get_meta_info(method_);
-	if(!meta)
+	// attributes are computed on first access
+	meta_ = get_meta_info(method_);
+
+	// filled here rather than on first use, so that invokers shared between
+	// threads never write to them
+	void* iter = nullptr;
+	auto type = mono_signature_get_params(signature_, &iter);
+	while(type)
 	{
-		meta = std::make_shared<meta_info>();
-		meta->name = get_name();
-		meta->fullname = get_fullname();
-		meta->full_declname = get_full_declname();
-		set_meta_info(method_, meta);
+		param_types_.emplace_back(type);
+		type = mono_signature_get_params(signature_, &iter);
 	}
-
-	meta_ = meta;
 }
 
 auto mono_method::get_return_type() const -> mono_type
@@ -126,55 +169,51 @@ auto mono_method::get_return_type() const -> mono_type
 	return mono_type(type);
 }
 
-void mono_method::cache_param_types() const
-{
-	if (!param_types_cached_)
-	{
-		void* iter = nullptr;
-		auto type = mono_signature_get_params(signature_, &iter);
-		while(type)
-		{
-			cached_param_types_.emplace_back(type);
-			type = mono_signature_get_params(signature_, &iter);
-		}
-		param_types_cached_ = true;
-	}
-}
-
 auto mono_method::get_param_types() const -> const std::vector<mono_type>&
 {
-	cache_param_types();
-	return cached_param_types_;
+	return param_types_;
 }
 
 auto mono_method::get_name() const -> std::string
 {
+	auto compute = [this]() -> std::string
+	{
+		return mono_method_get_name(method_);
+	};
 	if(meta_)
 	{
-		return meta_->name;
+		return meta_->name.get(compute);
 	}
-	return mono_method_get_name(method_);
+	return compute();
 }
 
 auto mono_method::get_fullname() const -> std::string
 {
+	auto compute = [this]() -> std::string
+	{
+		char* mono_name = mono_method_full_name(method_, true);
+		std::string name(mono_name);
+		mono_free(mono_name);
+		return name;
+	};
 	if(meta_)
 	{
-		return meta_->fullname;
+		return meta_->fullname.get(compute);
 	}
-	char* mono_name = mono_method_full_name(method_, true);
-	std::string name(mono_name);
-	mono_free(mono_name);
-	return name;
+	return compute();
 }
 auto mono_method::get_full_declname() const -> std::string
 {
+	auto compute = [this]() -> std::string
+	{
+		std::string storage = (is_static() ? " static " : " ");
+		return to_string(get_visibility()) + storage + get_fullname();
+	};
 	if(meta_)
 	{
-		return meta_->full_declname;
+		return meta_->full_declname.get(compute);
 	}
-	std::string storage = (is_static() ? " static " : " ");
-	return to_string(get_visibility()) + storage + get_fullname();
+	return compute();
 }
 auto mono_method::get_visibility() const -> visibility
 {
@@ -234,31 +273,10 @@ auto mono_method::is_synchronized() const -> bool
 	return (impl_flags & MONO_METHOD_IMPL_ATTR_SYNCHRONIZED) != 0;
 }
 
-auto mono_method::get_attributes() const -> std::vector<mono_type>
+auto mono_method::compute_attribute_classes() const -> std::vector<MonoClass*>
 {
-	std::vector<mono_type> result;
-
 	// Get custom attributes from the method
-	MonoCustomAttrInfo* attr_info = mono_custom_attrs_from_method(method_);
-
-	if(attr_info)
-	{
-		result.reserve(attr_info->num_attrs);
-
-		// Iterate over the custom attributes
-		for(int i = 0; i < attr_info->num_attrs; ++i)
-		{
-			MonoCustomAttrEntry* entry = &attr_info->attrs[i];
-
-			// Get the MonoClass* of the attribute
-			MonoClass* attr_class = mono_method_get_class(entry->ctor);
-
-			result.emplace_back(attr_class);
-		}
-
-		// Free the attribute info when done
-		mono_custom_attrs_free(attr_info);
-	}
+	auto result = detail::get_attribute_classes(mono_custom_attrs_from_method(method_));
 
 	// Get method flags
 	uint32_t impl_flags{};
@@ -312,6 +330,39 @@ auto mono_method::get_attributes() const -> std::vector<mono_type>
 	return result;
 }
 
+auto mono_method::get_attribute_classes() const -> const std::vector<MonoClass*>&
+{
+	if(meta_)
+	{
+		return meta_->attribute_classes.get([this]() { return compute_attribute_classes(); });
+	}
+	static const std::vector<MonoClass*> empty;
+	return empty;
+}
+
+auto mono_method::get_attributes() const -> std::vector<mono_type>
+{
+	const auto& classes = get_attribute_classes();
+	return std::vector<mono_type>(classes.begin(), classes.end());
+}
+
+auto mono_method::has_attribute(const mono_type& attribute) const -> bool
+{
+	return detail::find_attribute_class(get_attribute_classes(), attribute.get_internal_ptr()) != nullptr;
+}
+
+auto mono_method::get_attribute(const mono_type& attribute) const -> mono_object
+{
+	auto attr_class = detail::find_attribute_class(get_attribute_classes(), attribute.get_internal_ptr());
+	if(!attr_class)
+	{
+		return mono_object();
+	}
+	// pseudo attributes (e.g. SpecialName) are only flags and have no instance
+	auto attributes = detail::create_attributes(mono_custom_attrs_from_method(method_), attr_class);
+	return attributes.empty() ? mono_object() : attributes.front();
+}
+
 auto mono_method::valid() const -> bool
 {
 	return method_ != nullptr;
@@ -321,9 +372,44 @@ mono_method::operator bool() const
 {
 	return valid();
 }
+auto find_cached_method(const mono_type& type, const std::string& name, std::size_t signature_id) -> mono_method
+{
+	auto& cache = get_method_resolution_cache();
+	auto method = cache.find({type.get_internal_ptr(), mono_type::get_hash(name), signature_id});
+	if(!method)
+	{
+		return {};
+	}
+	// guard against name hash collisions
+	if(std::strcmp(mono_method_get_name(method->get_internal_ptr()), name.c_str()) != 0)
+	{
+		return {};
+	}
+	return *method;
+}
+
+void cache_method(const mono_type& type, const std::string& name, std::size_t signature_id,
+				  const mono_method& method)
+{
+	auto& cache = get_method_resolution_cache();
+	cache.emplace({type.get_internal_ptr(), mono_type::get_hash(name), signature_id}, method);
+}
+
 void reset_method_cache()
 {
 	auto& cache = get_method_cache();
 	cache.clear();
+
+	// the member tables of the types hold methods of the old cache, and
+	// resetting them drops the resolved methods as well
+	reset_type_cache();
+}
+
+namespace detail
+{
+void reset_method_resolution_cache()
+{
+	get_method_resolution_cache().clear();
 }
+} // namespace detail
 } // namespace mono
@@ -44,6 +44,13 @@ public:
 
 	auto get_attributes() const -> std::vector<mono_type>;
 
+	/// True if the method has an attribute of this class or a derived one.
+	/// Answered from the cached attribute classes, nothing is instantiated.
+	auto has_attribute(const mono_type& attribute) const -> bool;
+
+	/// Instantiates only the matching attribute.
+	auto get_attribute(const mono_type& attribute) const -> mono_object;
+
 	auto valid() const -> bool;
 	operator bool() const;
 
@@ -51,18 +58,34 @@ public:
 
 protected:
 	void generate_meta();
-	void cache_param_types() const;
+	auto compute_attribute_classes() const -> std::vector<MonoClass*>;
+	auto get_attribute_classes() const -> const std::vector<MonoClass*>&;
 
 	non_owning_ptr<MonoMethod> method_ = nullptr;
 	non_owning_ptr<MonoMethodSignature> signature_ = nullptr;
-	
-	// Cache param types to avoid repeated allocations
-	mutable std::vector<mono_type> cached_param_types_;
-	mutable bool param_types_cached_ = false;
 
-	std::shared_ptr<meta_info> meta_{};
+	/// Filled by the constructors, read only afterwards.
+	std::vector<mono_type> param_types_;
+
+	/// Owned by the meta cache: freed by reset_method_cache(), and by a domain
+	/// unload once every domain that was alive then is unloaded too.
+	meta_info* meta_ = nullptr;
 };
 
+/// Process-wide cache of resolved methods keyed by class, method name and
+/// a signature id (e.g. types::id<Signature>()). Cleared by reset_method_cache().
+auto find_cached_method(const mono_type& type, const std::string& name, std::size_t signature_id) -> mono_method;
+void cache_method(const mono_type& type, const std::string& name, std::size_t signature_id,
+				  const mono_method& method);
+
+/// Frees the cached metadata, see reset_type_cache().
+/// Also resets the type cache, whose member tables hold methods.
 void reset_method_cache();
 
+namespace detail
+{
+/// Called by reset_type_cache(), the resolved methods hold types.
+void reset_method_resolution_cache();
+} // namespace detail
+
 } // namespace mono
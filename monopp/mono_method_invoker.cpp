@@ -0,0 +1,158 @@
+#include "mono_method_invoker.h"
+#include "mono_thread.h"
+
+namespace mono
+{
+
+auto dispatch_stats::hit_rate() const -> double
+{
+	auto total = hits + misses;
+	if(total == 0)
+	{
+		return 0.0;
+	}
+	return double(hits) / double(total);
+}
+
+mono_method_invoker_base::mono_method_invoker_base(const mono_method& o)
+	: mono_method(o)
+{
+	if(method_)
+	{
+		is_static_ = is_static();
+		is_virtual_ = is_virtual();
+	}
+}
+
+auto mono_method_invoker_base::uses_unmanaged_thunk() const -> bool
+{
+	return thunk_ != nullptr;
+}
+
+auto mono_method_invoker_base::get_dispatch_stats() const -> dispatch_stats
+{
+	return dispatch_cache_.get_stats();
+}
+
+void mono_method_invoker_base::init_unmanaged_thunk()
+{
+	if(method_)
+	{
+		thunk_ = mono_method_get_unmanaged_thunk(method_);
+	}
+}
+
+void mono_method_invoker_base::resolve_target(const mono_object* obj, MonoObject*& object, MonoMethod*& method,
+											  void*& thunk)
+{
+	ensure_thread_attached();
+
+	method = method_;
+	thunk = thunk_;
+	if(obj && obj->valid())
+	{
+		object = obj->get_internal_ptr();
+		if(object && is_virtual_)
+		{
+			resolve_virtual(object, method, thunk);
+		}
+	}
+}
+
+void mono_method_invoker_base::resolve_virtual(MonoObject* object, MonoMethod*& method, void*& thunk)
+{
+	MonoClass* klass = mono_object_get_class(object);
+	if(dispatch_cache_.find(klass, method, thunk))
+	{
+		return;
+	}
+
+	method = mono_object_get_virtual_method(object, method_);
+	if(thunk_)
+	{
+		thunk = method == method_ ? thunk_ : mono_method_get_unmanaged_thunk(method);
+	}
+	dispatch_cache_.insert(klass, method, thunk);
+}
+
+mono_method_invoker_base::dispatch_cache::dispatch_cache(const dispatch_cache& other)
+{
+	*this = other;
+}
+
+auto mono_method_invoker_base::dispatch_cache::operator=(const dispatch_cache& other) -> dispatch_cache&
+{
+	if(this == &other)
+	{
+		return *this;
+	}
+
+	// only published entries are copied, a slot still being written is skipped
+	std::size_t count = 0;
+	for(auto& entry : entries_)
+	{
+		entry.klass.store(nullptr, std::memory_order_relaxed);
+	}
+	for(const auto& entry : other.entries_)
+	{
+		auto klass = entry.klass.load(std::memory_order_acquire);
+		if(klass)
+		{
+			entries_[count].method = entry.method;
+			entries_[count].thunk = entry.thunk;
+			entries_[count].klass.store(klass, std::memory_order_relaxed);
+			count++;
+		}
+	}
+	claimed_.store(count, std::memory_order_relaxed);
+	hits_.store(other.hits_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	misses_.store(other.misses_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	megamorphic_.store(other.megamorphic_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	return *this;
+}
+
+auto mono_method_invoker_base::dispatch_cache::find(MonoClass* klass, MonoMethod*& method, void*& thunk) const
+	-> bool
+{
+	for(const auto& entry : entries_)
+	{
+		if(entry.klass.load(std::memory_order_acquire) == klass)
+		{
+			hits_.fetch_add(1, std::memory_order_relaxed);
+			method = entry.method;
+			thunk = entry.thunk;
+			return true;
+		}
+	}
+	misses_.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+void mono_method_invoker_base::dispatch_cache::insert(MonoClass* klass, MonoMethod* method, void* thunk)
+{
+	// each slot is claimed by exactly one writer and never rewritten, two
+	// threads missing on the same class at once just use two slots
+	auto slot = claimed_.fetch_add(1, std::memory_order_relaxed);
+	if(slot >= entries_.size())
+	{
+		// megamorphic call site, keep doing the full lookup
+		megamorphic_.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	auto& entry = entries_[slot];
+	entry.method = method;
+	entry.thunk = thunk;
+	entry.klass.store(klass, std::memory_order_release);
+}
+
+auto mono_method_invoker_base::dispatch_cache::get_stats() const -> dispatch_stats
+{
+	dispatch_stats stats;
+	stats.hits = hits_.load(std::memory_order_relaxed);
+	stats.misses = misses_.load(std::memory_order_relaxed);
+	stats.megamorphic = megamorphic_.load(std::memory_order_relaxed);
+	return stats;
+}
+
+} // namespace mono
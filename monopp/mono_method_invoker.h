@@ -11,10 +11,231 @@
 #include <tuple>
 #include <utility>
 #include <array>
+#include <atomic>
 
 namespace mono
 {
 
+namespace detail
+{
+
+// Maps a native type to the type the unmanaged thunk expects for it.
+// References and primitives (including enums) are passed as is,
+// other value types are passed and returned boxed as MonoObject*.
+template <typename T>
+struct thunk_type
+{
+	using managed_type = typename mono_converter<std::decay_t<T>>::managed_type;
+
+	static constexpr bool is_boxed = !std::is_pointer<managed_type>::value &&
+									 !std::is_arithmetic<managed_type>::value &&
+									 !std::is_enum<managed_type>::value;
+
+	using thunk_t = std::conditional_t<is_boxed, MonoObject*, managed_type>;
+
+	static auto to_thunk(managed_type& value, const mono_type& type) -> thunk_t
+	{
+		return to_thunk_impl(value, type, std::integral_constant<bool, is_boxed>{});
+	}
+
+	static auto from_thunk(thunk_t value) -> std::decay_t<T>
+	{
+		return mono_converter<std::decay_t<T>>::from_mono(value);
+	}
+
+private:
+	static auto to_thunk_impl(managed_type& value, const mono_type& type, std::true_type) -> thunk_t
+	{
+		void* ptr = std::addressof(value);
+		return mono_value_box(mono_domain_get(), type.get_internal_ptr(), ptr);
+	}
+
+	static auto to_thunk_impl(managed_type& value, const mono_type&, std::false_type) -> thunk_t
+	{
+		return value;
+	}
+};
+
+template <typename RetType, typename... Args>
+struct thunk_caller
+{
+	using return_type = typename thunk_type<RetType>::thunk_t;
+	using instance_thunk_t = return_type (*)(MonoObject*, typename thunk_type<Args>::thunk_t..., MonoException**);
+	using static_thunk_t = return_type (*)(typename thunk_type<Args>::thunk_t..., MonoException**);
+
+	template <typename Tuple, std::size_t... I>
+	static auto call(void* thunk, bool is_static, MonoObject* object, const std::vector<mono_type>& param_types,
+					 Tuple& tup, std::index_sequence<I...>) -> std::decay_t<RetType>
+	{
+		MonoException* ex = nullptr;
+		return_type result{};
+		if(is_static)
+		{
+			auto func = reinterpret_cast<static_thunk_t>(thunk);
+			result = func(thunk_type<Args>::to_thunk(std::get<I>(tup), param_types[I])..., &ex);
+		}
+		else
+		{
+			auto func = reinterpret_cast<instance_thunk_t>(thunk);
+			result = func(object, thunk_type<Args>::to_thunk(std::get<I>(tup), param_types[I])..., &ex);
+		}
+		if(ex)
+		{
+			throw mono_thunk_exception(reinterpret_cast<MonoObject*>(ex));
+		}
+		return thunk_type<RetType>::from_thunk(result);
+	}
+};
+
+template <typename... Args>
+struct thunk_caller<void, Args...>
+{
+	using instance_thunk_t = void (*)(MonoObject*, typename thunk_type<Args>::thunk_t..., MonoException**);
+	using static_thunk_t = void (*)(typename thunk_type<Args>::thunk_t..., MonoException**);
+
+	template <typename Tuple, std::size_t... I>
+	static void call(void* thunk, bool is_static, MonoObject* object, const std::vector<mono_type>& param_types,
+					 Tuple& tup, std::index_sequence<I...>)
+	{
+		MonoException* ex = nullptr;
+		if(is_static)
+		{
+			auto func = reinterpret_cast<static_thunk_t>(thunk);
+			func(thunk_type<Args>::to_thunk(std::get<I>(tup), param_types[I])..., &ex);
+		}
+		else
+		{
+			auto func = reinterpret_cast<instance_thunk_t>(thunk);
+			func(object, thunk_type<Args>::to_thunk(std::get<I>(tup), param_types[I])..., &ex);
+		}
+		if(ex)
+		{
+			throw mono_thunk_exception(reinterpret_cast<MonoObject*>(ex));
+		}
+	}
+};
+
+template <typename RetType, typename... Args>
+struct runtime_invoke_caller
+{
+	template <typename Tuple, std::size_t... I>
+	static auto call(MonoMethod* method, MonoObject* object, const std::vector<mono_type>& param_types,
+					 Tuple& tup, std::index_sequence<I...>) -> MonoObject*
+	{
+		// Create args array with correct parameter types
+		std::array<void*, sizeof...(I)> argsv = {
+			{to_mono_arg(std::get<I>(tup), (I < param_types.size()) ? param_types[I] : mono_type{})...}};
+		mono::ignore(argsv, param_types);
+
+		MonoObject* ex = nullptr;
+		auto result = mono_runtime_invoke(method, object, argsv.data(), &ex);
+		if(ex)
+		{
+			throw mono_thunk_exception(ex);
+		}
+		return result;
+	}
+};
+
+// Calls an already resolved method with already converted arguments
+// either through its unmanaged thunk or through mono_runtime_invoke.
+template <typename RetType, typename... Args>
+struct invoke_caller
+{
+	template <typename Tuple>
+	static auto call(MonoMethod* method, void* thunk, bool is_static, MonoObject* object,
+					 const std::vector<mono_type>& param_types, Tuple& tup) -> std::decay_t<RetType>
+	{
+		if(thunk)
+		{
+			return thunk_caller<RetType, Args...>::call(thunk, is_static, object, param_types, tup,
+														std::index_sequence_for<Args...>{});
+		}
+		auto result = runtime_invoke_caller<RetType, Args...>::call(method, object, param_types, tup,
+																	 std::index_sequence_for<Args...>{});
+		return mono_converter<std::decay_t<RetType>>::from_mono(std::move(result));
+	}
+};
+
+template <typename... Args>
+struct invoke_caller<void, Args...>
+{
+	template <typename Tuple>
+	static void call(MonoMethod* method, void* thunk, bool is_static, MonoObject* object,
+					 const std::vector<mono_type>& param_types, Tuple& tup)
+	{
+		if(thunk)
+		{
+			thunk_caller<void, Args...>::call(thunk, is_static, object, param_types, tup,
+											  std::index_sequence_for<Args...>{});
+			return;
+		}
+		runtime_invoke_caller<void, Args...>::call(method, object, param_types, tup,
+												   std::index_sequence_for<Args...>{});
+	}
+};
+
+} // namespace detail
+
+namespace detail
+{
+template <typename T>
+struct builtin_class
+{
+	static auto get() -> MonoClass*
+	{
+		return nullptr;
+	}
+};
+
+#define MONOPP_BUILTIN_CLASS(cpp_type, getter)                                                                \
+	template <>                                                                                              \
+	struct builtin_class<cpp_type>                                                                           \
+	{                                                                                                        \
+		static auto get() -> MonoClass*                                                                      \
+		{                                                                                                    \
+			return getter();                                                                                 \
+		}                                                                                                    \
+	}
+
+MONOPP_BUILTIN_CLASS(std::int8_t, mono_get_sbyte_class);
+MONOPP_BUILTIN_CLASS(std::uint8_t, mono_get_byte_class);
+MONOPP_BUILTIN_CLASS(std::int16_t, mono_get_int16_class);
+MONOPP_BUILTIN_CLASS(std::uint16_t, mono_get_uint16_class);
+MONOPP_BUILTIN_CLASS(std::int32_t, mono_get_int32_class);
+MONOPP_BUILTIN_CLASS(std::uint32_t, mono_get_uint32_class);
+MONOPP_BUILTIN_CLASS(std::int64_t, mono_get_int64_class);
+MONOPP_BUILTIN_CLASS(std::uint64_t, mono_get_uint64_class);
+MONOPP_BUILTIN_CLASS(bool, mono_get_boolean_class);
+MONOPP_BUILTIN_CLASS(float, mono_get_single_class);
+MONOPP_BUILTIN_CLASS(double, mono_get_double_class);
+MONOPP_BUILTIN_CLASS(char16_t, mono_get_char_class);
+MONOPP_BUILTIN_CLASS(std::string, mono_get_string_class);
+MONOPP_BUILTIN_CLASS(void, mono_get_void_class);
+
+#undef MONOPP_BUILTIN_CLASS
+
+} // namespace detail
+
+/// The managed class a C++ type maps to, or nullptr when unknown.
+/// Filled lazily for the builtin types; other types (e.g. registered
+/// pod/wrapper converters) can bind theirs with register_type_class.
+template <typename T>
+auto get_type_class() -> MonoClass*&
+{
+	static MonoClass* cls = detail::builtin_class<T>::get();
+	return cls;
+}
+
+/// Binds the C++ type T to a managed type for signature checks.
+/// The binding refers to a class of the current domain and must be
+/// renewed after the domain that owns it is unloaded.
+template <typename T>
+void register_type_class(const mono_type& type)
+{
+	get_type_class<std::decay_t<T>>() = type.get_internal_ptr();
+}
+
 template <typename T>
 auto is_compatible_type(const mono_type& type) -> bool
 {
@@ -22,8 +243,12 @@ auto is_compatible_type(const mono_type& type) -> bool
 	{
 		return is_compatible_type<T>(type.get_enum_base_type());
 	}
-	const auto& expected_name = type.get_fullname();
-	return types::is_compatible_type<T>(expected_name);
+	auto cls = get_type_class<std::decay_t<T>>();
+	if(cls == nullptr)
+	{
+		return true;
+	}
+	return cls == type.get_internal_ptr();
 }
 
 template <typename Signature>
@@ -40,14 +265,10 @@ auto has_compatible_signature(const mono_method& method) -> bool
 	{
 		return false;
 	}
-	compatible &= is_compatible_type<return_type>(expected_rtype);
-	if(!compatible)
+	// allow cpp return type to be void i.e ignoring it.
+	if(!std::is_void<return_type>::value && !is_compatible_type<return_type>(expected_rtype))
 	{
-		// allow cpp return type to be void i.e ignoring it.
-		if(!is_compatible_type<void>(expected_rtype))
-		{
-			return false;
-		}
+		return false;
 	}
 	arg_types tuple;
 	size_t idx = 0;
@@ -65,11 +286,85 @@ auto has_compatible_signature(const mono_method& method) -> bool
 	return compatible;
 }
 
+/// Hit/miss counters of the per-invoker virtual dispatch cache.
+struct dispatch_stats
+{
+	std::uint64_t hits = 0;
+	std::uint64_t misses = 0;
+	std::uint64_t megamorphic = 0;
+
+	auto hit_rate() const -> double;
+};
+
+/// Common state of all method invokers: the optional unmanaged thunk and
+/// a small polymorphic inline cache that maps the receiver's MonoClass*
+/// to the resolved virtual MonoMethod* (and its thunk).
+///
+/// An invoker may be shared between threads. Cache entries are written
+/// once and published by their class pointer, so readers never see a
+/// half written entry.
+class mono_method_invoker_base : public mono_method
+{
+public:
+	static constexpr std::size_t dispatch_cache_size = 4;
+
+	auto uses_unmanaged_thunk() const -> bool;
+
+	/// A snapshot of the dispatch counters.
+	auto get_dispatch_stats() const -> dispatch_stats;
+
+protected:
+	explicit mono_method_invoker_base(const mono_method& o);
+
+	void init_unmanaged_thunk();
+
+	// Resolves the receiver, the method and the thunk (if any) to call for obj.
+	void resolve_target(const mono_object* obj, MonoObject*& object, MonoMethod*& method, void*& thunk);
+
+	void resolve_virtual(MonoObject* object, MonoMethod*& method, void*& thunk);
+
+	class dispatch_cache
+	{
+	public:
+		dispatch_cache() = default;
+		dispatch_cache(const dispatch_cache& other);
+		auto operator=(const dispatch_cache& other) -> dispatch_cache&;
+
+		auto find(MonoClass* klass, MonoMethod*& method, void*& thunk) const -> bool;
+
+		void insert(MonoClass* klass, MonoMethod* method, void* thunk);
+
+		auto get_stats() const -> dispatch_stats;
+
+	private:
+		struct entry
+		{
+			// set last, with release semantics, once method and thunk are written
+			std::atomic<MonoClass*> klass{nullptr};
+			non_owning_ptr<MonoMethod> method = nullptr;
+			void* thunk = nullptr;
+		};
+
+		std::array<entry, dispatch_cache_size> entries_{};
+		// slots handed out so far, may grow past the cache size
+		std::atomic<std::size_t> claimed_{0};
+		mutable std::atomic<std::uint64_t> hits_{0};
+		mutable std::atomic<std::uint64_t> misses_{0};
+		std::atomic<std::uint64_t> megamorphic_{0};
+	};
+
+	dispatch_cache dispatch_cache_;
+
+	void* thunk_ = nullptr;
+	bool is_static_ = false;
+	bool is_virtual_ = false;
+};
+
 template <typename T>
 class mono_method_invoker;
 
 template <typename... Args>
-class mono_method_invoker<void(Args...)> : public mono_method
+class mono_method_invoker<void(Args...)> : public mono_method_invoker_base
 {
 public:
 	void operator()(Args... args)
@@ -85,61 +380,34 @@ public:
 private:
 	void invoke(const mono_object* obj, Args... args)
 	{
-		auto method = this->method_;
-		if(!method)
+		if(!this->method_)
 		{
 			throw mono_exception("NATIVE::Method thunk requested with invalid method");
 		}
 		MonoObject* object = nullptr;
-		if(obj && obj->valid())
-		{
-			object = obj->get_internal_ptr();
-			if(object)
-			{
-				method = mono_object_get_virtual_method(object, method);
-			}
-		}
+		MonoMethod* method = nullptr;
+		void* thunk = nullptr;
+		resolve_target(obj, object, method, thunk);
 		auto tup = std::make_tuple(mono_converter<std::decay_t<Args>>::to_mono(std::forward<Args>(args))...);
 
 		const auto& param_types = this->get_param_types();
-		auto inv = [&](auto... args)
-		{
-			constexpr size_t N = sizeof...(args);
-			
-			// Create args array with correct parameter types (C++14 compatible)
-			std::array<void*, N> argsv;
-			size_t idx = 0;
-			
-			// C++14 compatible parameter pack expansion using initializer list
-			std::initializer_list<int> dummy = {(
-				argsv[idx] = to_mono_arg(args, (idx < param_types.size()) ? param_types[idx] : mono_type{}),
-				++idx,
-				0
-			)...};
-			(void)dummy; // Suppress unused variable warning
-
-			MonoObject* ex = nullptr;
-			mono_runtime_invoke(method, object, argsv.data(), &ex);
-			if(ex)
-			{
-				throw mono_thunk_exception(ex);
-			}
-		};
-
-		mono::apply(inv, tup);
+		detail::invoke_caller<void, Args...>::call(method, thunk, is_static_, object, param_types, tup);
 	}
 
 	template <typename Signature>
 	friend auto make_method_invoker(const mono_method&, bool) -> mono_method_invoker<Signature>;
 
+	template <typename Signature>
+	friend auto make_thunk_invoker(const mono_method&, bool) -> mono_method_invoker<Signature>;
+
 	mono_method_invoker(const mono_method& o)
-		: mono_method(o)
+		: mono_method_invoker_base(o)
 	{
 	}
 };
 
 template <typename RetType, typename... Args>
-class mono_method_invoker<RetType(Args...)> : public mono_method
+class mono_method_invoker<RetType(Args...)> : public mono_method_invoker_base
 {
 public:
 	auto operator()(Args... args)
@@ -155,58 +423,29 @@ public:
 private:
 	auto invoke(const mono_object* obj, Args... args)
 	{
-		auto method = this->method_;
-		if(!method)
+		if(!this->method_)
 		{
 			throw mono_exception("NATIVE::Method thunk requested with invalid method");
 		}
-
 		MonoObject* object = nullptr;
-		if(obj && obj->valid())
-		{
-			object = obj->get_internal_ptr();
-			if(object)
-			{
-				method = mono_object_get_virtual_method(object, method);
-			}
-		}
+		MonoMethod* method = nullptr;
+		void* thunk = nullptr;
+		resolve_target(obj, object, method, thunk);
 		auto tup = std::make_tuple(mono_converter<std::decay_t<Args>>::to_mono(std::forward<Args>(args))...);
-		const auto& param_types = this->get_param_types();
-		auto inv = [&](auto... args)
-		{
-			constexpr size_t N = sizeof...(args);
-			
-			// Create args array with correct parameter types (C++14 compatible)
-			std::array<void*, N> argsv;
-			size_t idx = 0;
-			
-			// C++14 compatible parameter pack expansion using initializer list
-			std::initializer_list<int> dummy = {(
-				argsv[idx] = to_mono_arg(args, (idx < param_types.size()) ? param_types[idx] : mono_type{}),
-				++idx,
-				0
-			)...};
-			(void)dummy; // Suppress unused variable warning
-
-			MonoObject* ex = nullptr;
-			auto result = mono_runtime_invoke(method, object, argsv.data(), &ex);
-			if(ex)
-			{
-				throw mono_thunk_exception(ex);
-			}
-
-			return result;
-		};
 
-		auto result = mono::apply(inv, tup);
-		return mono_converter<std::decay_t<RetType>>::from_mono(std::move(result));
+		const auto& param_types = this->get_param_types();
+		return detail::invoke_caller<RetType, Args...>::call(method, thunk, is_static_, object, param_types,
+															 tup);
 	}
 
 	template <typename Signature>
 	friend auto make_method_invoker(const mono_method&, bool) -> mono_method_invoker<Signature>;
 
+	template <typename Signature>
+	friend auto make_thunk_invoker(const mono_method&, bool) -> mono_method_invoker<Signature>;
+
 	mono_method_invoker(const mono_method& o)
-		: mono_method(o)
+		: mono_method_invoker_base(o)
 	{
 	}
 };
@@ -225,21 +464,31 @@ auto make_method_invoker(const mono_method& method, bool check_signature = true)
 template <typename Signature>
 auto make_method_invoker(const mono_type& type, const std::string& name) -> mono_method_invoker<Signature>
 {
+	const auto signature_id = types::id<Signature>();
+	auto cached = find_cached_method(type, name, signature_id);
+	if(cached.valid())
+	{
+		// signature was already checked when it got cached
+		return make_method_invoker<Signature>(cached, false);
+	}
+
 	using arg_types = typename function_traits<Signature>::arg_types;
-	auto args_result = types::get_args_signature<arg_types>();
+	static const auto args_result = types::get_args_signature<arg_types>();
 	auto all_types_known = args_result.second;
 
-	if(all_types_known)
-	{
-		auto func = type.get_method(name + "(" + args_result.first + ")");
-		return make_method_invoker<Signature>(func);
-	}
-	else
+	auto func = [&]()
 	{
+		if(all_types_known)
+		{
+			return type.get_method(name + "(" + args_result.first + ")");
+		}
 		constexpr auto arg_count = function_traits<Signature>::arity;
-		auto func = type.get_method(name, arg_count);
-		return make_method_invoker<Signature>(func);
-	}
+		return type.get_method(name, arg_count);
+	}();
+
+	auto invoker = make_method_invoker<Signature>(func);
+	cache_method(type, name, signature_id, func);
+	return invoker;
 }
 
 template <typename Signature>
@@ -250,4 +499,37 @@ auto make_method_invoker(const mono_object& obj, const std::string& name) -> mon
 	return make_method_invoker<Signature>(type, name);
 }
 
+/// Same as make_method_invoker, but calls go through the method's unmanaged thunk
+/// (mono_method_get_unmanaged_thunk) as a typed native function pointer instead of
+/// mono_runtime_invoke. Falls back to mono_runtime_invoke if no thunk is available.
+template <typename Signature>
+auto make_thunk_invoker(const mono_method& method, bool check_signature = true)
+	-> mono_method_invoker<Signature>
+{
+	using return_type = typename function_traits<Signature>::return_type;
+	auto invoker = make_method_invoker<Signature>(method, check_signature);
+	// a discarded managed result goes through mono_runtime_invoke, calling
+	// the thunk as if it returned void isn't safe for every return type
+	if(!std::is_void<return_type>::value || is_compatible_type<void>(method.get_return_type()))
+	{
+		invoker.init_unmanaged_thunk();
+	}
+	return invoker;
+}
+
+template <typename Signature>
+auto make_thunk_invoker(const mono_type& type, const std::string& name) -> mono_method_invoker<Signature>
+{
+	auto invoker = make_method_invoker<Signature>(type, name);
+	return make_thunk_invoker<Signature>(invoker, false);
+}
+
+template <typename Signature>
+auto make_thunk_invoker(const mono_object& obj, const std::string& name) -> mono_method_invoker<Signature>
+{
+	const auto& type = obj.get_type();
+
+	return make_thunk_invoker<Signature>(type, name);
+}
+
 } // namespace mono
@@ -1,6 +1,7 @@
 #include "mono_object.h"
 #include "mono_domain.h"
 #include "mono_string.h"
+#include "mono_thread.h"
 
 namespace mono
 {
@@ -15,6 +16,7 @@ mono_object::mono_object(MonoObject* object)
 {
 	if(object_)
 	{
+		ensure_thread_attached();
 		type_ = mono_type(mono_object_get_class(object));
 	}
 }
@@ -28,6 +30,7 @@ mono_object::mono_object(MonoObject* object, const mono_type& type)
 mono_object::mono_object(const mono_domain& domain, const mono_type& type)
 	: type_(type)
 {
+	ensure_thread_attached();
 	MonoClass* klass = type.get_internal_ptr();
 
     if (mono_class_is_valuetype(klass))
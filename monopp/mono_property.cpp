@@ -1,9 +1,9 @@
 #include "mono_property.h"
+#include "mono_attributes.h"
 #include "mono_exception.h"
 #include "mono_method.h"
 #include "mono_object.h"
-
-#include <unordered_map>
+#include "mono_meta_cache.h"
 
 BEGIN_MONO_INCLUDE
 #include <mono/metadata/appdomain.h>
@@ -15,35 +15,26 @@ namespace mono
 {
 struct mono_property::meta_info
 {
-	std::string name;
-	std::string fullname;
-	std::string full_declname;
+	lazy_value<std::string> name;
+	lazy_value<std::string> fullname;
+	lazy_value<std::string> full_declname;
+	lazy_value<std::vector<MonoClass*>> attribute_classes;
+	lazy_value<MonoClassField*> backing_field;
 };
 
 namespace
 {
 
-auto get_property_cache() -> std::unordered_map<MonoProperty*, std::shared_ptr<mono_property::meta_info>>&
+auto get_property_cache() -> mono_meta_cache<MonoProperty*, mono_property::meta_info>&
 {
-	static std::unordered_map<MonoProperty*, std::shared_ptr<mono_property::meta_info>> property_cache;
+	static mono_meta_cache<MonoProperty*, mono_property::meta_info> property_cache;
 	return property_cache;
 }
 
-auto get_meta_info(MonoProperty* property) -> std::shared_ptr<mono_property::meta_info>
+auto get_meta_info(MonoProperty* property) -> mono_property::meta_info*
 {
 	auto& cache = get_property_cache();
-	auto it = cache.find(property);
-	if(it != cache.end())
-	{
-		return it->second;
-	}
-	return nullptr;
-}
-
-void set_meta_info(MonoProperty* property, std::shared_ptr<mono_property::meta_info> meta)
-{
-	auto& cache = get_property_cache();
-	cache[property] = meta;
+	return &cache.find_or_emplace(property);
 }
 
 } // namespace
@@ -60,7 +51,21 @@ mono_property::mono_property(const mono_type& type, const std::string& name)
 	{
 		throw mono_exception("NATIVE::Could not get property : " + name + " for class " + type.get_name());
 	}
-	
+	init();
+}
+
+mono_property::mono_property(MonoProperty* property)
+	: property_(property)
+{
+	if(!property_)
+	{
+		throw mono_exception("NATIVE::Could not get property : null handle");
+	}
+	init();
+}
+
+void mono_property::init()
+{
 	auto get_method = get_get_method();
 	type_ = get_method.get_return_type();
 
@@ -74,30 +79,42 @@ auto mono_property::get_internal_ptr() const -> MonoProperty*
 
 auto mono_property::get_name() const -> std::string
 {
+	auto compute = [this]() -> std::string
+	{
+		return mono_property_get_name(get_internal_ptr());
+	};
 	if(meta_)
 	{
-		return meta_->name;
+		return meta_->name.get(compute);
 	}
-	return mono_property_get_name(get_internal_ptr());
+	return compute();
 }
 
 auto mono_property::get_fullname() const -> std::string
 {
+	auto compute = [this]() -> std::string
+	{
+		return mono_property_get_name(get_internal_ptr());
+	};
 	if(meta_)
 	{
-		return meta_->fullname;
+		return meta_->fullname.get(compute);
 	}
-	return mono_property_get_name(get_internal_ptr());
+	return compute();
 }
 
 auto mono_property::get_full_declname() const -> std::string
 {
+	auto compute = [this]() -> std::string
+	{
+		std::string storage = (is_static() ? " static " : " ");
+		return to_string(get_visibility()) + storage + get_name();
+	};
 	if(meta_)
 	{
-		return meta_->full_declname;
+		return meta_->full_declname.get(compute);
 	}
-	std::string storage = (is_static() ? " static " : " ");
-	return to_string(get_visibility()) + storage + get_name();
+	return compute();
 }
 
 auto mono_property::get_type() const -> const mono_type&
@@ -116,6 +133,41 @@ auto mono_property::get_set_method() const -> mono_method
 	return mono_method(method);
 }
 
+auto mono_property::get_backing_field() const -> MonoClassField*
+{
+	auto compute = [this]() -> MonoClassField*
+	{
+		mono_type compiler_generated(mono_class_from_name(
+			mono_get_corlib(), "System.Runtime.CompilerServices", "CompilerGeneratedAttribute"));
+		for(auto accessor : {mono_property_get_get_method(property_), mono_property_get_set_method(property_)})
+		{
+			if(!accessor)
+			{
+				continue;
+			}
+			// an override could do more than touch the field, and hand
+			// written accessors may share the field name (C# 'field' keyword)
+			auto flags = mono_method_get_flags(accessor, nullptr);
+			if((flags & MONO_METHOD_ATTR_VIRTUAL) != 0 && (flags & MONO_METHOD_ATTR_FINAL) == 0)
+			{
+				return nullptr;
+			}
+			if(!mono_method(accessor).has_attribute(compiler_generated))
+			{
+				return nullptr;
+			}
+		}
+
+		auto name = "<" + get_name() + ">k__BackingField";
+		return mono_class_get_field_from_name(mono_property_get_parent(property_), name.c_str());
+	};
+	if(meta_)
+	{
+		return meta_->backing_field.get(compute);
+	}
+	return compute();
+}
+
 auto mono_property::get_visibility() const -> visibility
 {
 	auto getter_vis = visibility::vis_public;
@@ -162,89 +214,74 @@ auto mono_property::is_readonly() const -> bool
 
 void mono_property::generate_meta()
 {
-	auto meta = get_meta_info(property_);
-	if(!meta)
-	{
-		meta = std::make_shared<meta_info>();
-		meta->name = get_name();
-		meta->fullname = get_fullname();
-		meta->full_declname = get_full_declname();
-		set_meta_info(property_, meta);
-	}
-
-	meta_ = meta;
+	// attributes are computed on first access
+	meta_ = get_meta_info(property_);
 }
 
-auto mono_property::get_attributes() const -> std::vector<mono_object>
+auto mono_property::get_attribute_classes() const -> const std::vector<MonoClass*>&
 {
-	std::vector<mono_object> result;
-
-	auto parent_class = mono_property_get_parent(property_);
-
-	// Get custom attributes from the property
-	MonoCustomAttrInfo* attr_info = mono_custom_attrs_from_property(parent_class, property_);
-
-	if(attr_info)
+	auto compute = [this]() -> std::vector<MonoClass*>
 	{
-		result.reserve(attr_info->num_attrs);
-
-		// Iterate over the custom attributes
-		for(int i = 0; i < attr_info->num_attrs; ++i)
-		{
-			MonoCustomAttrEntry* entry = &attr_info->attrs[i];
-
-			// Get the MonoClass* of the attribute
-			MonoClass* attr_class = mono_method_get_class(entry->ctor);
+		return detail::get_attribute_classes(
+			mono_custom_attrs_from_property(mono_property_get_parent(property_), property_));
+	};
+	return meta_->attribute_classes.get(compute);
+}
 
-			if(attr_class)
-			{
-				MonoObject* attr_obj = mono_custom_attrs_get_attr(attr_info, attr_class);
-				// Add the attribute instance to the result vector
-				if(attr_obj)
-				{
-					result.emplace_back(attr_obj);
-				}
-			}
-		}
-		// Free the attribute info when done
-		mono_custom_attrs_free(attr_info);
+auto mono_property::create_attributes(MonoClass* attribute) const -> std::vector<mono_object>
+{
+	// nothing is instantiated for properties without attributes
+	if(get_attribute_classes().empty())
+	{
+		return {};
 	}
+	return detail::create_attributes(
+		mono_custom_attrs_from_property(mono_property_get_parent(property_), property_), attribute);
+}
 
-	return result;
+auto mono_property::get_attributes() const -> std::vector<mono_object>
+{
+	return create_attributes(nullptr);
 }
 
 auto mono_property::has_attribute_fullname(const std::string& attribute_full_name) const -> bool
 {
-	return get_attribute_fullname(attribute_full_name).valid();
+	return detail::find_attribute_class(get_attribute_classes(), attribute_full_name, true) != nullptr;
 }
 
 auto mono_property::has_attribute(const std::string& attribute_name) const -> bool
 {
-	return get_attribute(attribute_name).valid();
+	return detail::find_attribute_class(get_attribute_classes(), attribute_name, false) != nullptr;
+}
+
+auto mono_property::has_attribute(const mono_type& attribute) const -> bool
+{
+	return detail::find_attribute_class(get_attribute_classes(), attribute.get_internal_ptr()) != nullptr;
 }
 
 auto mono_property::get_attribute(const std::string& attribute_name) const -> mono_object
 {
-	for (auto& attr_obj : get_attributes())
-	{
-		if(attribute_name == attr_obj.get_type().get_name())
-		{
-			return attr_obj;
-		}
-	}
-	return mono_object();
+	return get_attribute(detail::find_attribute_class(get_attribute_classes(), attribute_name, false));
 }
 
 auto mono_property::get_attribute_fullname(const std::string& attribute_full_name) const -> mono_object
 {
-	for (auto& attr_obj : get_attributes())
+	return get_attribute(detail::find_attribute_class(get_attribute_classes(), attribute_full_name, true));
+}
+
+auto mono_property::get_attribute(const mono_type& attribute) const -> mono_object
+{
+	return get_attribute(detail::find_attribute_class(get_attribute_classes(), attribute.get_internal_ptr()));
+}
+
+auto mono_property::get_attribute(MonoClass* attribute) const -> mono_object
+{
+	if(!attribute)
 	{
-		if(attribute_full_name == attr_obj.get_type().get_fullname())
-		{
-			return attr_obj;
-		}
+		return mono_object();
 	}
-	return mono_object();
+	auto attributes = create_attributes(attribute);
+	return attributes.empty() ? mono_object() : attributes.front();
 }
 auto mono_property::is_special_name() const -> bool
 {
@@ -261,5 +298,8 @@ void reset_property_cache()
 {
 	auto& cache = get_property_cache();
 	cache.clear();
+
+	// the member tables of the types hold properties of the old cache
+	reset_type_cache();
 }
 } // namespace mono
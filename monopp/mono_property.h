@@ -20,6 +20,7 @@ public:
 	struct meta_info;
 
 	explicit mono_property(const mono_type& type, const std::string& name);
+	explicit mono_property(MonoProperty* property);
 
 	auto get_name() const -> std::string;
 
@@ -45,8 +46,15 @@ public:
 
 	auto has_attribute(const std::string& attribute_name) const -> bool;
 
+	/// True if the property has an attribute of this class or a derived one.
+	/// Answered from the cached attribute classes, nothing is instantiated.
+	auto has_attribute(const mono_type& attribute) const -> bool;
+
 	auto get_attribute(const std::string& attribute_name) const -> mono_object;
 
+	/// Instantiates only the matching attribute.
+	auto get_attribute(const mono_type& attribute) const -> mono_object;
+
 	auto get_attribute_fullname(const std::string& attribute_full_name) const -> mono_object;
 
 	auto is_special_name() const -> bool;
@@ -55,16 +63,33 @@ public:
 
 	auto get_internal_ptr() const -> MonoProperty*;
 
+protected:
+	/// The compiler generated field of an auto-property whose accessors
+	/// can't be overridden, nullptr for any other property.
+	auto get_backing_field() const -> MonoClassField*;
+
 private:
+	void init();
+
 	void generate_meta();
 
+	auto get_attribute_classes() const -> const std::vector<MonoClass*>&;
+
+	auto create_attributes(MonoClass* attribute) const -> std::vector<mono_object>;
+
+	auto get_attribute(MonoClass* attribute) const -> mono_object;
+
 	mono_type type_;
 
 	non_owning_ptr<MonoProperty> property_ = nullptr;
 
-	std::shared_ptr<meta_info> meta_{};
+	/// Owned by the meta cache: freed by reset_property_cache(), and by a domain
+	/// unload once every domain that was alive then is unloaded too.
+	meta_info* meta_ = nullptr;
 };
 
+/// Frees the cached metadata, see reset_type_cache().
+/// Also resets the type cache, whose member tables hold properties.
 void reset_property_cache();
 
 } // namespace mono
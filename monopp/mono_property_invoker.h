@@ -1,6 +1,7 @@
 #pragma once
 #include "mono_property.h"
 
+#include "mono_field_invoker.h"
 #include "mono_method_invoker.h"
 
 namespace mono
@@ -32,41 +33,165 @@ public:
 	template <typename IndexArg>
 	void set_value_with_args(const mono_object& obj, IndexArg index, const T& val) const;
 
+	/// True if get_value/set_value access the auto-property's backing field
+	/// directly instead of calling the accessors.
+	auto is_direct() const -> bool;
+
 private:
 	template <typename Signature>
 	friend auto make_property_invoker(const mono_property&) -> mono_property_invoker<Signature>;
 
+	using getter_t = mono_method_invoker<T()>;
+	using setter_t = mono_method_invoker<void(T)>;
+	using field_t = mono_field_invoker<T>;
+
 	explicit mono_property_invoker(const mono_property& property)
 		: mono_property(property)
 	{
+		init_accessors();
 	}
+
+	void init_accessors();
+
+	/// The accessors, throwing mono_exception if the property has none.
+	auto get_getter() const -> mono_method;
+	auto get_setter() const -> mono_method;
+
+	// Shared so copies of the invoker reuse what was resolved. An accessor
+	// that failed to resolve stays null and is looked up again per call,
+	// which reports the error as before.
+	std::shared_ptr<getter_t> getter_;
+	std::shared_ptr<setter_t> setter_;
+	std::shared_ptr<const field_t> backing_field_;
 };
 
+template <typename T>
+void mono_property_invoker<T>::init_accessors()
+{
+	// get- or set-only properties lack an accessor and indexers take the
+	// index as well, neither gets a thunk
+	auto get_method = get_get_method();
+	if(get_method.get_internal_ptr() && get_method.get_param_types().empty())
+	{
+		try
+		{
+			getter_ = std::make_shared<getter_t>(make_thunk_invoker<T()>(get_method));
+		}
+		catch(const mono_exception&)
+		{
+		}
+	}
+	auto set_method = get_set_method();
+	if(set_method.get_internal_ptr() && set_method.get_param_types().size() == 1)
+	{
+		try
+		{
+			setter_ = std::make_shared<setter_t>(make_thunk_invoker<void(T)>(set_method));
+		}
+		catch(const mono_exception&)
+		{
+		}
+	}
+
+	if(auto field = get_backing_field())
+	{
+		auto invoker = make_field_invoker<T>(mono_field(field));
+		if(invoker.is_direct())
+		{
+			backing_field_ = std::make_shared<field_t>(invoker);
+		}
+	}
+}
+
+template <typename T>
+auto mono_property_invoker<T>::get_getter() const -> mono_method
+{
+	auto method = get_get_method();
+	if(!method.get_internal_ptr())
+	{
+		throw mono_exception("NATIVE::Property has no getter : " + get_name());
+	}
+	return method;
+}
+
+template <typename T>
+auto mono_property_invoker<T>::get_setter() const -> mono_method
+{
+	auto method = get_set_method();
+	if(!method.get_internal_ptr())
+	{
+		throw mono_exception("NATIVE::Property has no setter : " + get_name());
+	}
+	return method;
+}
+
+template <typename T>
+auto mono_property_invoker<T>::is_direct() const -> bool
+{
+	return backing_field_ != nullptr;
+}
+
 template <typename T>
 void mono_property_invoker<T>::set_value(const T& val) const
 {
-	auto thunk = make_method_invoker<void(const T&)>(get_set_method());
+	if(setter_ && backing_field_)
+	{
+		backing_field_->set_value(val);
+		return;
+	}
+	if(setter_)
+	{
+		(*setter_)(val);
+		return;
+	}
+	auto thunk = make_method_invoker<void(const T&)>(get_setter());
 	thunk(val);
 }
 
 template <typename T>
 void mono_property_invoker<T>::set_value(const mono_object& object, const T& val) const
 {
-	auto thunk = make_method_invoker<void(const T&)>(get_set_method());
+	if(setter_ && backing_field_)
+	{
+		backing_field_->set_value(object, val);
+		return;
+	}
+	if(setter_)
+	{
+		(*setter_)(object, val);
+		return;
+	}
+	auto thunk = make_method_invoker<void(const T&)>(get_setter());
 	thunk(object, val);
 }
 
 template <typename T>
 auto mono_property_invoker<T>::get_value() const -> T
 {
-	auto thunk = make_method_invoker<T()>(get_get_method());
+	if(getter_ && backing_field_)
+	{
+		return backing_field_->get_value();
+	}
+	if(getter_)
+	{
+		return (*getter_)();
+	}
+	auto thunk = make_method_invoker<T()>(get_getter());
 	return thunk();
 }
 
 template <typename T>
 auto mono_property_invoker<T>::get_value(const mono_object& object) const -> T
 {
-	auto thunk = make_method_invoker<T()>(get_get_method());
+	if(getter_ && backing_field_)
+	{
+		return backing_field_->get_value(object);
+	}
+	if(getter_)
+	{
+		return (*getter_)(object);
+	}
+	auto thunk = make_method_invoker<T()>(get_getter());
 	return thunk(object);
 }
 
@@ -74,7 +199,7 @@ template <typename T>
 template <typename IndexArg>
 auto mono_property_invoker<T>::get_value_with_args(IndexArg index) const -> T
 {
-	auto thunk = make_method_invoker<T(IndexArg)>(get_get_method());
+	auto thunk = make_method_invoker<T(IndexArg)>(get_getter());
 	return thunk(index);
 }
 
@@ -82,7 +207,7 @@ template <typename T>
 template <typename IndexArg>
 auto mono_property_invoker<T>::get_value_with_args(const mono_object& object, IndexArg index) const -> T
 {
-	auto thunk = make_method_invoker<T(IndexArg)>(get_get_method());
+	auto thunk = make_method_invoker<T(IndexArg)>(get_getter());
 	return thunk(object, index);
 }
 
@@ -90,7 +215,7 @@ template <typename T>
 template <typename IndexArg>
 void mono_property_invoker<T>::set_value_with_args(IndexArg index, const T& val) const
 {
-	auto thunk = make_method_invoker<void(IndexArg, const T&)>(get_set_method());
+	auto thunk = make_method_invoker<void(IndexArg, const T&)>(get_setter());
 	thunk(index, val);
 }
 
@@ -98,7 +223,7 @@ template <typename T>
 template <typename IndexArg>
 void mono_property_invoker<T>::set_value_with_args(const mono_object& object, IndexArg index, const T& val) const
 {
-	auto thunk = make_method_invoker<void(IndexArg, const T&)>(get_set_method());
+	auto thunk = make_method_invoker<void(IndexArg, const T&)>(get_setter());
 	thunk(object, index, val);
 }
 
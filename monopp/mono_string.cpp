@@ -1,5 +1,6 @@
 #include "mono_string.h"
 #include "mono_domain.h"
+#include "mono_thread.h"
 
 DIAG_PUSH_PRAGMA
 DIAG_DISABLE_WARNING(conversion, character-conversion, 4244)
@@ -8,13 +9,22 @@ DIAG_POP_PRAGMA
 namespace mono
 {
 
+namespace
+{
+auto new_string(const mono_domain& domain, const std::string& str) -> MonoObject*
+{
+	ensure_thread_attached();
+	return reinterpret_cast<MonoObject*>(mono_string_new(domain.get_internal_ptr(), str.c_str()));
+}
+} // namespace
+
 mono_string::mono_string(const mono_object& obj)
 	: mono_object(obj)
 {
 }
 
 mono_string::mono_string(const mono_domain& domain, const std::string& str)
-	: mono_object(reinterpret_cast<MonoObject*>(mono_string_new(domain.get_internal_ptr(), str.c_str())))
+	: mono_object(new_string(domain, str))
 {
 }
 
@@ -0,0 +1,185 @@
+#include "mono_thread.h"
+
+BEGIN_MONO_INCLUDE
+#include <mono/metadata/appdomain.h>
+END_MONO_INCLUDE
+
+#include <atomic>
+#include <chrono>
+
+namespace mono
+{
+
+namespace
+{
+std::atomic<MonoDomain*> target_domain{nullptr};
+std::atomic<std::uint64_t> attach_generation{1};
+std::atomic<bool> runtime_active{true};
+
+std::atomic<std::uint64_t> attached_count{0};
+std::atomic<std::uint64_t> detached_count{0};
+std::atomic<std::uint64_t> rebound_count{0};
+std::atomic<std::uint64_t> total_attach_ns{0};
+std::atomic<std::uint64_t> max_attach_ns{0};
+
+void detach(MonoThread*& thread)
+{
+	if(thread && runtime_active.load(std::memory_order_acquire))
+	{
+		mono_thread_detach(thread);
+		detached_count++;
+	}
+	thread = nullptr;
+}
+
+struct thread_record
+{
+	~thread_record()
+	{
+		detach(thread);
+	}
+
+	MonoThread* thread = nullptr;
+	std::uint64_t generation = 0;
+};
+
+auto get_thread_record() -> thread_record&
+{
+	static thread_local thread_record record;
+	return record;
+}
+
+auto get_target_domain() -> MonoDomain*
+{
+	auto domain = target_domain.load(std::memory_order_acquire);
+	if(domain)
+	{
+		return domain;
+	}
+	return mono_get_root_domain();
+}
+
+void record_attach_cost(std::uint64_t ns)
+{
+	attached_count++;
+	total_attach_ns += ns;
+	auto current_max = max_attach_ns.load();
+	while(ns > current_max && !max_attach_ns.compare_exchange_weak(current_max, ns))
+	{
+	}
+}
+
+void attach(thread_record& record, std::uint64_t generation)
+{
+	auto domain = get_target_domain();
+	if(!domain || !runtime_active.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	if(record.thread)
+	{
+		mono_thread_attach(domain);
+		rebound_count++;
+	}
+	else
+	{
+		// attached by someone else, which may have detached it since
+		auto current = mono_domain_get();
+		if(current != nullptr)
+		{
+			if(current != domain)
+			{
+				mono_domain_set(domain, 0);
+			}
+			return;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		record.thread = mono_thread_attach(domain);
+		auto end = std::chrono::steady_clock::now();
+		record_attach_cost(
+			std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+	}
+	record.generation = generation;
+}
+
+} // namespace
+
+auto thread_attach_stats::average_attach_ns() const -> double
+{
+	if(attached == 0)
+	{
+		return 0.0;
+	}
+	return double(total_attach_ns) / double(attached);
+}
+
+void ensure_thread_attached()
+{
+	auto& record = get_thread_record();
+	auto generation = attach_generation.load(std::memory_order_acquire);
+	if(record.thread && record.generation == generation)
+	{
+		return;
+	}
+	attach(record, generation);
+}
+
+void detach_current_thread()
+{
+	auto& record = get_thread_record();
+	detach(record.thread);
+	record.generation = 0;
+}
+
+auto is_thread_attached() -> bool
+{
+	return get_thread_record().thread != nullptr;
+}
+
+auto get_thread_attach_stats() -> thread_attach_stats
+{
+	thread_attach_stats stats;
+	stats.attached = attached_count.load();
+	stats.detached = detached_count.load();
+	stats.rebound = rebound_count.load();
+	stats.total_attach_ns = total_attach_ns.load();
+	stats.max_attach_ns = max_attach_ns.load();
+	return stats;
+}
+
+void set_thread_attach_domain(MonoDomain* domain)
+{
+	target_domain.store(domain, std::memory_order_release);
+	attach_generation++;
+}
+
+void invalidate_thread_attachments(MonoDomain* unloaded)
+{
+	auto expected = unloaded;
+	target_domain.compare_exchange_strong(expected, nullptr);
+	attach_generation++;
+}
+
+void shutdown_thread_attachments()
+{
+	runtime_active.store(false, std::memory_order_release);
+}
+
+mono_thread_scope::mono_thread_scope()
+{
+	bool was_attached = is_thread_attached();
+	ensure_thread_attached();
+	owns_attachment_ = !was_attached && is_thread_attached();
+}
+
+mono_thread_scope::~mono_thread_scope()
+{
+	if(owns_attachment_)
+	{
+		detach_current_thread();
+	}
+}
+
+} // namespace mono
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "mono_config.h"
+
+BEGIN_MONO_INCLUDE
+#include <mono/metadata/threads.h>
+END_MONO_INCLUDE
+
+#include <cstdint>
+
+namespace mono
+{
+
+/// Process-wide counters of the thread attachment registry.
+struct thread_attach_stats
+{
+	std::uint64_t attached = 0;
+	std::uint64_t detached = 0;
+	std::uint64_t rebound = 0;
+	std::uint64_t total_attach_ns = 0;
+	std::uint64_t max_attach_ns = 0;
+
+	/// Threads currently attached by the registry.
+	auto active() const -> std::uint64_t
+	{
+		return attached - detached;
+	}
+
+	auto average_attach_ns() const -> double;
+};
+
+/// Makes sure the calling thread can run managed code in the current domain.
+/// A native thread gets attached on first use and detached again when it exits.
+/// Threads attached by someone else (e.g. the main thread) are not owned, only
+/// switched to the current domain; they are checked on every call, and get
+/// attached and owned once they turn out to have been detached.
+/// Cheap to call once attached: a thread local lookup and a generation check.
+void ensure_thread_attached();
+
+/// Detaches the calling thread now if it was attached by the registry.
+void detach_current_thread();
+
+/// True if the registry attached the calling thread.
+auto is_thread_attached() -> bool;
+
+auto get_thread_attach_stats() -> thread_attach_stats;
+
+/// Called when the current domain changes so that attached threads
+/// rebind to it on their next call. nullptr means the root domain.
+void set_thread_attach_domain(MonoDomain* domain);
+
+/// Called before a domain unloads; threads bound to it rebind on their next call.
+/// Worker threads must not be running managed code while a domain unloads.
+/// They are not detached: a thread can only detach itself, so they stay
+/// attached until they exit or call detach_current_thread().
+void invalidate_thread_attachments(MonoDomain* unloaded);
+
+/// Called on shutdown, after which exiting threads no longer detach.
+void shutdown_thread_attachments();
+
+/// Keeps the calling thread attached for the lifetime of the scope.
+/// If the scope performed the attachment it detaches the thread when it
+/// ends, otherwise it leaves the thread as it found it.
+class mono_thread_scope
+{
+public:
+	mono_thread_scope();
+	~mono_thread_scope();
+
+	mono_thread_scope(const mono_thread_scope&) = delete;
+	auto operator=(const mono_thread_scope&) -> mono_thread_scope& = delete;
+
+	auto owns_attachment() const -> bool
+	{
+		return owns_attachment_;
+	}
+
+private:
+	bool owns_attachment_ = false;
+};
+
+} // namespace mono
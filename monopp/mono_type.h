@@ -1,6 +1,7 @@
 #pragma once
 
 #include "mono_config.h"
+#include "mono_hash.h"
 
 BEGIN_MONO_INCLUDE
 #include "mono/metadata/appdomain.h"
@@ -23,6 +24,7 @@ class mono_type
 {
 public:
     struct meta_info;
+	struct enum_table;
 
 	mono_type();
 
@@ -44,14 +46,24 @@ public:
 
 	auto get_property(const std::string& name) const -> mono_property;
 
-	auto get_fields(bool include_base = false) const -> std::vector<mono_field>;
+	/// Member tables are built from the class handles on first access and
+	/// shared by every mono_type of the class until reset_type_cache().
+	/// Members of base types come first when include_base is set.
+	auto get_fields(bool include_base = false) const -> const std::vector<mono_field>&;
 
-	auto get_properties(bool include_base = false) const -> std::vector<mono_property>;
+	auto get_properties(bool include_base = false) const -> const std::vector<mono_property>&;
 
-	auto get_methods(bool include_base = false) const -> std::vector<mono_method>;
+	auto get_methods(bool include_base = false) const -> const std::vector<mono_method>&;
 
 	auto get_attributes(bool include_base = false) const -> std::vector<mono_object>;
 
+	/// True if the class has an attribute of this class or a derived one.
+	/// Answered from the cached attribute classes, nothing is instantiated.
+	auto has_attribute(const mono_type& attribute, bool include_base = false) const -> bool;
+
+	/// Instantiates only the matching attribute, searching from this class up.
+	auto get_attribute(const mono_type& attribute, bool include_base = false) const -> mono_object;
+
 	auto has_base_type() const -> bool;
 
 	auto get_base_type() const -> mono_type;
@@ -72,6 +84,10 @@ public:
 
 	auto is_valuetype() const -> bool;
 
+	/// True for primitives, enums and structs made only of those, i.e.
+	/// values whose bytes can be copied without GC write barriers.
+	auto is_blittable() const -> bool;
+
 	auto is_struct() const -> bool;
 
 	auto is_class() const -> bool;
@@ -80,9 +96,31 @@ public:
 
 	auto get_enum_base_type() const -> mono_type;
 
+	/// Enum constants in System.Enum.GetValues order. Read from the metadata
+	/// once per class, nothing is allocated on the managed heap.
 	template<typename T>
 	auto get_enum_values() const -> std::vector<std::pair<T, std::string>>;
 
+	/// Name of the enum constant with this value, nullptr if there is none.
+	template<typename T>
+	auto get_enum_name(T value) const -> const std::string*
+	{
+		return find_enum_name(std::uint64_t(value));
+	}
+
+	/// Looks up the enum constant called name, false if there is none.
+	template<typename T>
+	auto get_enum_value(const std::string& name, T& value) const -> bool
+	{
+		std::uint64_t bits = 0;
+		if(!find_enum_value(name, bits))
+		{
+			return false;
+		}
+		value = T(bits);
+		return true;
+	}
+
 	auto get_rank() const -> int;
 	
 	auto is_array() const -> bool;
@@ -103,20 +141,39 @@ public:
 	auto get_internal_ptr() const -> MonoClass*;
 
 	static auto get_hash(const std::string& name) -> size_t;
-	static auto get_hash(const char* name) -> size_t;
+	static constexpr auto get_hash(const char* name) -> size_t
+	{
+		return size_t(crc64(name));
+	}
 
 private:
 	auto get_name(bool full) const -> std::string;
+	auto get_name_uncached(bool full) const -> std::string;
 	auto get_array_element_type() const -> mono_type;
 	auto get_list_element_type() const -> mono_type;
 	void gather_nested_types_recursive(std::vector<mono_type>& nested_types) const;
+	auto get_attribute_classes() const -> const std::vector<MonoClass*>&;
+	auto get_attribute_owner(const mono_type& attribute, bool include_base) const -> mono_type;
+	auto get_enum_table() const -> const enum_table&;
+	auto find_enum_name(std::uint64_t bits) const -> const std::string*;
+	auto find_enum_value(const std::string& name, std::uint64_t& bits) const -> bool;
 
 	void generate_meta();
 
 	non_owning_ptr<MonoClass> class_ = nullptr;
-	std::shared_ptr<meta_info> meta_{};
+	/// Owned by the meta cache: freed by reset_type_cache(), and by a domain
+	/// unload once every domain that was alive then is unloaded too.
+	meta_info* meta_ = nullptr;
 };
 
+/// Frees the cached metadata; wrappers created before are invalid afterwards.
+/// Not safe while other threads use mono_type.
 void reset_type_cache();
 
+namespace detail
+{
+/// The classes that have metadata in the type cache.
+auto get_cached_classes() -> std::vector<MonoClass*>;
+} // namespace detail
+
 } // namespace mono
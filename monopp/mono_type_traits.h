@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <map>
@@ -177,9 +178,9 @@ namespace types
 {
 using index_t = size_t;
 
-inline auto get_counter() -> index_t&
+inline auto get_counter() -> std::atomic<index_t>&
 {
-	static index_t value = 0;
+	static std::atomic<index_t> value{0};
 	return value;
 }
 
@@ -196,32 +197,77 @@ struct type_names_t
 	std::string fullname;
 };
 
+// Compile-time name table of the builtin types.
+// valid shortcuts are
+// char, bool, byte, sbyte, uint16,
+// int16, uint, int, ulong, long, uintptr,
+// intptr, single, double, string and object.
+template <typename T>
+struct type_name_traits
+{
+	static constexpr const bool known = false;
+	static constexpr auto name() -> const char*
+	{
+		return "unknown";
+	}
+	static constexpr auto fullname() -> const char*
+	{
+		return "Unknown";
+	}
+};
+
+#define MONOPP_TYPE_NAME_TRAITS(cpp_type, short_name, full_name)                                             \
+	template <>                                                                                              \
+	struct type_name_traits<cpp_type>                                                                        \
+	{                                                                                                        \
+		static constexpr const bool known = true;                                                            \
+		static constexpr auto name() -> const char*                                                          \
+		{                                                                                                    \
+			return short_name;                                                                               \
+		}                                                                                                    \
+		static constexpr auto fullname() -> const char*                                                      \
+		{                                                                                                    \
+			return full_name;                                                                                \
+		}                                                                                                    \
+	}
+
+// clang-format off
+MONOPP_TYPE_NAME_TRAITS(std::int8_t, "sbyte", "System.SByte");
+MONOPP_TYPE_NAME_TRAITS(std::uint8_t, "byte", "System.Byte");
+MONOPP_TYPE_NAME_TRAITS(std::int16_t, "short", "System.Int16");
+MONOPP_TYPE_NAME_TRAITS(std::uint16_t, "ushort", "System.UInt16");
+MONOPP_TYPE_NAME_TRAITS(std::int32_t, "int", "System.Int32");
+MONOPP_TYPE_NAME_TRAITS(std::uint32_t, "uint", "System.UInt32");
+MONOPP_TYPE_NAME_TRAITS(std::int64_t, "long", "System.Int64");
+MONOPP_TYPE_NAME_TRAITS(std::uint64_t, "ulong", "System.UInt64");
+MONOPP_TYPE_NAME_TRAITS(bool, "bool", "System.Boolean");
+MONOPP_TYPE_NAME_TRAITS(float, "single", "System.Single");
+MONOPP_TYPE_NAME_TRAITS(double, "double", "System.Double");
+MONOPP_TYPE_NAME_TRAITS(char16_t, "char", "System.Char");
+MONOPP_TYPE_NAME_TRAITS(std::string, "string", "System.String");
+MONOPP_TYPE_NAME_TRAITS(void, "void", "System.Void");
+// clang-format on
+
+#undef MONOPP_TYPE_NAME_TRAITS
+
 inline auto get_types() -> const std::map<index_t, type_names_t>&
 {
-	// valid shortcuts are
-	// char, bool, byte, sbyte, uint16,
-	// int16, uint, int, ulong, long, uintptr,
-	// intptr, single, double, string and object.
-
-	// clang-format off
-	static const std::map<index_t, type_names_t> types =
-    {
-        {id<std::int8_t>(), {"sbyte", "System.SByte"}},
-        {id<std::uint8_t>(), {"byte", "System.Byte"}}, 
-        {id<std::int16_t>(), {"short", "System.Int16"}},
-        {id<std::uint16_t>(), {"ushort", "System.UInt16"}},
-        {id<std::int32_t>(), {"int", "System.Int32"}},
-        {id<std::uint32_t>(), {"uint", "System.UInt32"}},
-        {id<std::int64_t>(), {"long", "System.Int64"}},
-        {id<std::uint64_t>(), {"ulong", "System.UInt64"}},
-        {id<bool>(), {"bool", "System.Boolean"}},
-        {id<float>(), {"single", "System.Single"}},
-        {id<double>(), {"double", "System.Double"}},
-        {id<char16_t>(), {"char", "System.Char"}},
-        {id<std::string>(), {"string", "System.String"}},
-        {id<void>(), {"void", "System.Void"}}
-    };
-	// clang-format on
+	static const std::map<index_t, type_names_t> types = []()
+	{
+		std::map<index_t, type_names_t> result;
+		// clang-format off
+		mono::for_each_type<std::int8_t, std::uint8_t, std::int16_t, std::uint16_t,
+							std::int32_t, std::uint32_t, std::int64_t, std::uint64_t,
+							bool, float, double, char16_t, std::string, void>(
+			[&](auto tag)
+			{
+				using type = type_t<decltype(tag)>;
+				using traits = type_name_traits<type>;
+				result.emplace(id<type>(), type_names_t{traits::name(), traits::fullname()});
+			});
+		// clang-format on
+		return result;
+	}();
 
 	return types;
 }
@@ -229,16 +275,10 @@ inline auto get_types() -> const std::map<index_t, type_names_t>&
 template <typename T>
 inline auto get_name(bool& found) -> const type_names_t&
 {
-	const auto& types = get_types();
-	auto it = types.find(id<std::decay_t<T>>());
-	if(it == types.end())
-	{
-		found |= false;
-		static const type_names_t empty{"unknown", "Unknown"};
-		return empty;
-	}
-	found |= true;
-	return it->second;
+	using traits = type_name_traits<std::decay_t<T>>;
+	found |= traits::known;
+	static const type_names_t names{traits::name(), traits::fullname()};
+	return names;
 }
 
 template <typename Tuple>
@@ -272,13 +312,10 @@ inline auto get_args_signature() -> std::pair<std::string, bool>
 template <typename T>
 auto is_compatible_type(const std::string& expected_name) -> bool
 {
-	bool found = false;
-
-	const auto& name = types::get_name<T>(found).fullname;
-
-	if(found)
+	using traits = type_name_traits<std::decay_t<T>>;
+	if(traits::known)
 	{
-		return name == expected_name;
+		return expected_name == traits::fullname();
 	}
 
 	return true;
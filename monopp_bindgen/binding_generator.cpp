@@ -0,0 +1,587 @@
+#include "binding_generator.h"
+
+#include <monopp/mono_exception.h>
+#include <monopp/mono_field.h>
+#include <monopp/mono_method.h>
+#include <monopp/mono_property.h>
+#include <monopp/mono_type.h>
+
+BEGIN_MONO_INCLUDE
+#include <mono/metadata/attrdefs.h>
+#include <mono/metadata/debug-helpers.h>
+END_MONO_INCLUDE
+
+#include <cctype>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace bindgen
+{
+namespace
+{
+
+// How a managed type is spelled in the generated code.
+struct cpp_type
+{
+	// in invoker signatures and return types
+	std::string value;
+	// in wrapper parameters
+	std::string param;
+};
+
+auto map_type(MonoType* type, cpp_type& result) -> bool
+{
+	static const std::unordered_map<std::string, std::string> builtins = {
+		{"System.SByte", "std::int8_t"},	 {"System.Byte", "std::uint8_t"},
+		{"System.Int16", "std::int16_t"},	 {"System.UInt16", "std::uint16_t"},
+		{"System.Int32", "std::int32_t"},	 {"System.UInt32", "std::uint32_t"},
+		{"System.Int64", "std::int64_t"},	 {"System.UInt64", "std::uint64_t"},
+		{"System.Boolean", "bool"},		 {"System.Single", "float"},
+		{"System.Double", "double"},		 {"System.Char", "char16_t"},
+		{"System.String", "std::string"}, {"System.Void", "void"}};
+
+	// ref, out and generic parameters have no mapping
+	if(!type || mono_type_is_byref(type))
+	{
+		return false;
+	}
+	auto kind = mono_type_get_type(type);
+	if(kind == MONO_TYPE_VAR || kind == MONO_TYPE_MVAR)
+	{
+		return false;
+	}
+
+	mono::mono_type managed(type);
+	if(!managed.valid())
+	{
+		return false;
+	}
+	auto it = builtins.find(managed.get_fullname());
+	if(it != builtins.end())
+	{
+		result.value = it->second;
+		result.param = it->second == "std::string" ? "const std::string&" : it->second;
+		return true;
+	}
+
+	// structs and enums need a hand written mapping
+	if(managed.is_valuetype())
+	{
+		return false;
+	}
+	result.value = "mono::mono_object";
+	result.param = "const mono::mono_object&";
+	return true;
+}
+
+auto to_identifier(const std::string& name) -> std::string
+{
+	static const std::unordered_set<std::string> keywords = {
+		"alignas",	"alignof",	 "and",		 "asm",		  "auto",	  "bool",	   "break",	  "case",
+		"catch",	"char",		 "class",	 "const",	  "constexpr", "continue", "default",  "delete",
+		"do",		"double",	 "else",	 "enum",	  "explicit",  "export",   "extern",   "false",
+		"float",	"for",		 "friend",	 "goto",	  "if",		   "inline",   "int",	   "long",
+		"mutable",	"namespace", "new",		 "noexcept",  "not",	   "nullptr",  "operator", "or",
+		"private",	"protected", "public",	 "register",  "return",	   "short",	   "signed",   "sizeof",
+		"static",	"struct",	 "switch",	 "template",  "this",	   "throw",	   "true",	   "try",
+		"typedef",	"typeid",	 "typename", "union",	  "unsigned",  "using",	   "virtual",  "void",
+		"volatile", "while",	 "xor",		 "self",	  "value",	   "context",  "type"};
+
+	std::string id;
+	for(auto c : name)
+	{
+		id.push_back(std::isalnum(static_cast<unsigned char>(c)) ? c : '_');
+	}
+	if(id.empty() || std::isdigit(static_cast<unsigned char>(id.front())))
+	{
+		id.insert(0, "_");
+	}
+	if(keywords.count(id) != 0)
+	{
+		id.push_back('_');
+	}
+	return id;
+}
+
+auto to_hex(uint32_t token) -> std::string
+{
+	std::ostringstream out;
+	out << "0x" << std::hex << std::setw(8) << std::setfill('0') << token;
+	return out.str();
+}
+
+auto quote(const std::string& str) -> std::string
+{
+	std::string result = "\"";
+	for(auto c : str)
+	{
+		if(c == '"' || c == '\\')
+		{
+			result.push_back('\\');
+		}
+		result.push_back(c);
+	}
+	result.push_back('"');
+	return result;
+}
+
+auto join(const std::vector<std::string>& parts) -> std::string
+{
+	std::string result;
+	for(const auto& part : parts)
+	{
+		if(!result.empty())
+		{
+			result += ", ";
+		}
+		result += part;
+	}
+	return result;
+}
+
+auto is_public(uint32_t flags) -> bool
+{
+	return (flags & MONO_METHOD_ATTR_ACCESS_MASK) == MONO_METHOD_ATTR_PUBLIC;
+}
+
+auto is_bindable(const mono::mono_type& type) -> bool
+{
+	auto flags = mono_class_get_flags(type.get_internal_ptr());
+	auto visibility = flags & MONO_TYPE_ATTR_VISIBILITY_MASK;
+	if(visibility != MONO_TYPE_ATTR_PUBLIC && visibility != MONO_TYPE_ATTR_NESTED_PUBLIC)
+	{
+		return false;
+	}
+	// generic definitions have no concrete members to bind
+	auto fullname = type.get_fullname();
+	return !type.is_interface() && !type.is_enum() && fullname.find_first_of("`<") == std::string::npos;
+}
+
+// Collects the slots and wrapper functions of one bound type.
+class type_writer
+{
+public:
+	explicit type_writer(const mono::mono_type& type)
+		: type_(type)
+	{
+		// names the wrapper class defines itself
+		signatures_ = {"bind(const mono::mono_binding_context&)", "unbind()", "is_bound()", "get_type()"};
+	}
+
+	void add_method(MonoMethod* method)
+	{
+		uint32_t impl_flags = 0;
+		auto flags = mono_method_get_flags(method, &impl_flags);
+		// constructors, accessors and operators have special names
+		if(!is_public(flags) || (flags & MONO_METHOD_ATTR_SPECIAL_NAME) != 0)
+		{
+			return;
+		}
+
+		auto sig = mono_method_signature(method);
+		cpp_type ret;
+		bool supported = map_type(mono_signature_get_return_type(sig), ret);
+		std::vector<cpp_type> params;
+		void* iter = nullptr;
+		while(auto param = mono_signature_get_params(sig, &iter))
+		{
+			cpp_type mapped;
+			supported = map_type(param, mapped) && supported;
+			params.push_back(mapped);
+		}
+		if(!supported)
+		{
+			skipped_.push_back(mono::mono_method(method).get_full_declname());
+			return;
+		}
+
+		std::vector<const char*> param_names(params.size(), nullptr);
+		if(!param_names.empty())
+		{
+			mono_method_get_param_names(method, param_names.data());
+		}
+
+		bool is_static = (flags & MONO_METHOD_ATTR_STATIC) != 0;
+		std::vector<std::string> values;
+		std::vector<std::string> declarations;
+		std::vector<std::string> arguments;
+		std::vector<std::string> overload_types;
+		if(!is_static)
+		{
+			declarations.emplace_back("const mono::mono_object& self");
+			arguments.emplace_back("self");
+			overload_types.emplace_back("const mono::mono_object&");
+		}
+		for(size_t i = 0; i < params.size(); ++i)
+		{
+			auto name = param_names[i] && *param_names[i] ? to_identifier(param_names[i])
+														   : "arg" + std::to_string(i);
+			values.push_back(params[i].value);
+			declarations.push_back(params[i].param + " " + name);
+			arguments.push_back(name);
+			overload_types.push_back(params[i].param);
+		}
+
+		std::string name = mono_method_get_name(method);
+		char* desc = mono_signature_get_desc(sig, false);
+		std::string name_with_args = name + "(" + desc + ")";
+		mono_free(desc);
+
+		auto slot = "method_" + std::to_string(slots_.size());
+		auto signature = ret.value + "(" + join(values) + ")";
+		add_slot("mono::mono_method_invoker<" + signature + "> " + slot,
+				 slot + "(mono::make_thunk_invoker<" + signature + ">(context.get_method(type, " +
+					 to_hex(mono_method_get_token(method)) + ", " + quote(name_with_args) + "), !context.uses_tokens()))");
+
+		auto wrapper = unique_name(to_identifier(name), join(overload_types));
+		auto call = "slots()->" + slot + "(" + join(arguments) + ")";
+		add_function(wrapper, declarations, ret.value, call);
+	}
+
+	void add_field(MonoClassField* field)
+	{
+		auto flags = mono_field_get_flags(field);
+		// constants have no storage to read
+		if((flags & MONO_FIELD_ATTR_FIELD_ACCESS_MASK) != MONO_FIELD_ATTR_PUBLIC ||
+		   (flags & MONO_FIELD_ATTR_LITERAL) != 0)
+		{
+			return;
+		}
+
+		std::string name = mono_field_get_name(field);
+		cpp_type type;
+		if(!map_type(mono_field_get_type(field), type) || type.value == "void")
+		{
+			skipped_.push_back(type_.get_fullname() + "." + name);
+			return;
+		}
+
+		auto slot = "field_" + std::to_string(slots_.size());
+		add_slot("mono::mono_field_invoker<" + type.value + "> " + slot,
+				 slot + "(mono::make_field_invoker<" + type.value + ">(context.get_field(type, " +
+					 to_hex(mono_class_get_field_token(field)) + ", " + quote(name) + ")))");
+
+		bool is_static = (flags & MONO_FIELD_ATTR_STATIC) != 0;
+		auto id = to_identifier(name);
+		add_accessors(id, slot, type, is_static, (flags & MONO_FIELD_ATTR_INIT_ONLY) == 0, ".get_value",
+					  ".set_value");
+	}
+
+	void add_property(MonoProperty* property)
+	{
+		auto getter = mono_property_get_get_method(property);
+		auto setter = mono_property_get_set_method(property);
+		if(getter && !is_public(mono_method_get_flags(getter, nullptr)))
+		{
+			getter = nullptr;
+		}
+		if(setter && !is_public(mono_method_get_flags(setter, nullptr)))
+		{
+			setter = nullptr;
+		}
+		if(!getter && !setter)
+		{
+			return;
+		}
+
+		std::string name = mono_property_get_name(property);
+		auto getter_sig = getter ? mono_method_signature(getter) : nullptr;
+		auto setter_sig = setter ? mono_method_signature(setter) : nullptr;
+
+		cpp_type type;
+		bool supported = false;
+		if(getter_sig)
+		{
+			supported = mono_signature_get_param_count(getter_sig) == 0 &&
+						map_type(mono_signature_get_return_type(getter_sig), type);
+		}
+		else if(mono_signature_get_param_count(setter_sig) == 1)
+		{
+			void* iter = nullptr;
+			supported = map_type(mono_signature_get_params(setter_sig, &iter), type);
+		}
+		// indexers take extra arguments
+		if(!supported || (setter_sig && mono_signature_get_param_count(setter_sig) != 1))
+		{
+			skipped_.push_back(type_.get_fullname() + "." + name);
+			return;
+		}
+
+		auto slot = "property_" + std::to_string(slots_.size());
+		auto lookup = "context.get_property(type, " + quote(name) + ")";
+		if(getter)
+		{
+			add_slot("mono::mono_method_invoker<" + type.value + "()> " + slot + "_get",
+					 slot + "_get(mono::make_thunk_invoker<" + type.value + "()>(" + lookup +
+						 ".get_get_method(), !context.uses_tokens()))");
+		}
+		if(setter)
+		{
+			add_slot("mono::mono_method_invoker<void(" + type.value + ")> " + slot + "_set",
+					 slot + "_set(mono::make_thunk_invoker<void(" + type.value + ")>(" + lookup +
+						 ".get_set_method(), !context.uses_tokens()))");
+		}
+
+		auto accessor = getter ? getter : setter;
+		bool is_static = (mono_method_get_flags(accessor, nullptr) & MONO_METHOD_ATTR_STATIC) != 0;
+		add_accessors(to_identifier(name), slot, type, is_static, setter != nullptr, getter ? "_get" : "",
+					  "_set");
+	}
+
+	void write(std::ostream& out, const std::string& class_name) const
+	{
+		out << "class " << class_name << "\n";
+		out << "{\n";
+		out << "public:\n";
+		out << "\tstatic void bind(const mono::mono_binding_context& context)\n";
+		out << "\t{\n";
+		out << "\t\tslots().reset(new slots_t(context));\n";
+		out << "\t}\n\n";
+		out << "\t/// Drops the invokers, which point into the domain they were bound in.\n";
+		out << "\tstatic void unbind()\n";
+		out << "\t{\n";
+		out << "\t\tslots().reset();\n";
+		out << "\t}\n\n";
+		out << "\tstatic auto is_bound() -> bool\n";
+		out << "\t{\n";
+		out << "\t\treturn slots() != nullptr;\n";
+		out << "\t}\n\n";
+		out << "\tstatic auto get_type() -> const mono::mono_type&\n";
+		out << "\t{\n";
+		out << "\t\treturn slots()->type;\n";
+		out << "\t}\n";
+		for(const auto& function : functions_)
+		{
+			out << "\n" << function;
+		}
+		if(!skipped_.empty())
+		{
+			out << "\n\t// no C++ mapping for:\n";
+			for(const auto& skipped : skipped_)
+			{
+				out << "\t// " << skipped << "\n";
+			}
+		}
+
+		out << "\nprivate:\n";
+		out << "\tstruct slots_t\n";
+		out << "\t{\n";
+		out << "\t\texplicit slots_t(const mono::mono_binding_context& context)\n";
+		out << "\t\t\t: type(context.get_type(" << to_hex(mono_class_get_type_token(type_.get_internal_ptr()))
+			<< ", " << quote(type_.get_fullname()) << "))\n";
+		for(const auto& slot : slots_)
+		{
+			out << "\t\t\t, " << slot.second << "\n";
+		}
+		out << "\t\t{\n";
+		out << "\t\t}\n\n";
+		out << "\t\tmono::mono_type type;\n";
+		for(const auto& slot : slots_)
+		{
+			out << "\t\t" << slot.first << ";\n";
+		}
+		out << "\t};\n\n";
+		out << "\tstatic auto slots() -> std::unique_ptr<slots_t>&\n";
+		out << "\t{\n";
+		out << "\t\tstatic std::unique_ptr<slots_t> instance;\n";
+		out << "\t\treturn instance;\n";
+		out << "\t}\n";
+		out << "};\n";
+	}
+
+private:
+	void add_slot(const std::string& declaration, const std::string& initializer)
+	{
+		slots_.emplace_back(declaration, initializer);
+	}
+
+	// Appends _2, _3... to overloads whose C++ parameters are the same.
+	auto unique_name(const std::string& name, const std::string& params) -> std::string
+	{
+		auto candidate = name;
+		for(int i = 2; !signatures_.insert(candidate + "(" + params + ")").second; ++i)
+		{
+			candidate = name + "_" + std::to_string(i);
+		}
+		return candidate;
+	}
+
+	void add_function(const std::string& name, const std::vector<std::string>& params,
+					  const std::string& ret, const std::string& call)
+	{
+		std::string function = "\tstatic ";
+		function += ret == "void" ? "void " + name + "(" + join(params) + ")\n"
+								  : "auto " + name + "(" + join(params) + ") -> " + ret + "\n";
+		function += "\t{\n";
+		function += ret == "void" ? "\t\t" + call + ";\n" : "\t\treturn " + call + ";\n";
+		function += "\t}\n";
+		functions_.push_back(function);
+	}
+
+	// get_/set_ wrappers of fields (through the field invoker) and properties
+	// (through their accessor invokers)
+	void add_accessors(const std::string& name, const std::string& slot, const cpp_type& type, bool is_static,
+					   bool writable, const std::string& get_suffix, const std::string& set_suffix)
+	{
+		std::vector<std::string> params;
+		std::vector<std::string> arguments;
+		if(!is_static)
+		{
+			params.emplace_back("const mono::mono_object& self");
+			arguments.emplace_back("self");
+		}
+
+		if(!get_suffix.empty())
+		{
+			auto getter = unique_name("get_" + name, is_static ? "" : "const mono::mono_object&");
+			add_function(getter, params, type.value, "slots()->" + slot + get_suffix + "(" + join(arguments) + ")");
+		}
+		if(writable)
+		{
+			auto setter = unique_name("set_" + name, join(is_static ? std::vector<std::string>{type.param}
+																	 : std::vector<std::string>{
+																		   "const mono::mono_object&", type.param}));
+			params.push_back(type.param + " value");
+			arguments.emplace_back("value");
+			add_function(setter, params, "void", "slots()->" + slot + set_suffix + "(" + join(arguments) + ")");
+		}
+	}
+
+	mono::mono_type type_;
+	std::vector<std::pair<std::string, std::string>> slots_;
+	std::vector<std::string> functions_;
+	std::vector<std::string> skipped_;
+	std::unordered_set<std::string> signatures_;
+};
+
+auto get_class_name(const mono::mono_type& type) -> std::string
+{
+	auto fullname = type.get_fullname();
+	auto name_space = type.get_namespace();
+	if(!name_space.empty() && fullname.compare(0, name_space.size() + 1, name_space + ".") == 0)
+	{
+		fullname = fullname.substr(name_space.size() + 1);
+	}
+	// nested types are flattened into Outer_Inner
+	return to_identifier(fullname);
+}
+
+auto split_namespace(const std::string& name_space) -> std::vector<std::string>
+{
+	std::vector<std::string> parts;
+	std::istringstream in(name_space);
+	std::string part;
+	while(std::getline(in, part, '.'))
+	{
+		parts.push_back(to_identifier(part));
+	}
+	return parts;
+}
+
+} // namespace
+
+auto generate_bindings(const mono::mono_assembly& assembly, const std::string& assembly_name,
+					   const generator_options& options) -> std::string
+{
+	std::vector<mono::mono_type> types;
+	if(options.types.empty())
+	{
+		for(const auto& type : assembly.get_types())
+		{
+			if(is_bindable(type))
+			{
+				types.push_back(type);
+			}
+		}
+	}
+	else
+	{
+		for(const auto& name : options.types)
+		{
+			auto type = assembly.get_type(name);
+			if(!type.valid())
+			{
+				throw mono::mono_exception("NATIVE::Could not find type to bind : " + name);
+			}
+			types.push_back(type);
+		}
+	}
+
+	auto assembly_id = to_identifier(assembly_name);
+	std::ostringstream out;
+	out << "// Generated by monopp_bindgen from " << assembly_name << ", do not edit.\n";
+	out << "#pragma once\n\n";
+	out << "#include <monopp/mono_binding.h>\n";
+	out << "#include <monopp/mono_field_invoker.h>\n";
+	out << "#include <monopp/mono_method_invoker.h>\n\n";
+	out << "#include <cstdint>\n";
+	out << "#include <memory>\n";
+	out << "#include <string>\n\n";
+	out << "namespace " << options.output_namespace << "\n{\n\n";
+	out << "/// MVID of the build the metadata tokens below were read from.\n";
+	out << "constexpr const char* " << assembly_id << "_mvid = " << quote(assembly.get_mvid()) << ";\n\n";
+
+	std::vector<std::string> bound;
+	for(const auto& type : types)
+	{
+		type_writer writer(type);
+		for(const auto& field : type.get_fields())
+		{
+			writer.add_field(field.get_internal_ptr());
+		}
+		for(const auto& property : type.get_properties())
+		{
+			writer.add_property(property.get_internal_ptr());
+		}
+		for(const auto& method : type.get_methods())
+		{
+			writer.add_method(method.get_internal_ptr());
+		}
+
+		auto namespaces = split_namespace(type.get_namespace());
+		for(const auto& part : namespaces)
+		{
+			out << "namespace " << part << "\n{\n";
+		}
+		auto class_name = get_class_name(type);
+		writer.write(out, class_name);
+		for(auto it = namespaces.rbegin(); it != namespaces.rend(); ++it)
+		{
+			out << "} // namespace " << *it << "\n";
+		}
+		out << "\n";
+
+		std::string qualified;
+		for(const auto& part : namespaces)
+		{
+			qualified += part + "::";
+		}
+		bound.push_back(qualified + class_name);
+	}
+
+	out << "/// Binds every type above, call it once the assembly is loaded.\n";
+	out << "/// Token lookups are used when the MVID matches, otherwise members are\n";
+	out << "/// looked up by name and their signatures checked.\n";
+	out << "inline void bind_" << assembly_id << "(const mono::mono_assembly& assembly)\n";
+	out << "{\n";
+	out << "\tmono::mono_binding_context context(assembly, " << assembly_id << "_mvid);\n";
+	for(const auto& name : bound)
+	{
+		out << "\t" << name << "::bind(context);\n";
+	}
+	out << "}\n\n";
+	out << "/// Unbinds every type above, call it before the domain is unloaded.\n";
+	out << "inline void unbind_" << assembly_id << "()\n";
+	out << "{\n";
+	for(const auto& name : bound)
+	{
+		out << "\t" << name << "::unbind();\n";
+	}
+	out << "}\n\n";
+	out << "} // namespace " << options.output_namespace << "\n";
+	return out.str();
+}
+
+} // namespace bindgen
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <monopp/mono_assembly.h>
+
+#include <string>
+#include <vector>
+
+namespace bindgen
+{
+
+struct generator_options
+{
+	// C++ namespace the bindings are generated into
+	std::string output_namespace = "bindings";
+
+	// Full names of the types to bind, all public types when empty
+	std::vector<std::string> types;
+};
+
+/// Generates a header with a typed wrapper class for every selected type.
+/// Members whose signatures have no C++ mapping are listed as skipped.
+/// The bound invokers live in statics until unbind_<assembly_name>().
+auto generate_bindings(const mono::mono_assembly& assembly, const std::string& assembly_name,
+					   const generator_options& options) -> std::string;
+
+} // namespace bindgen
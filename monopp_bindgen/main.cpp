@@ -0,0 +1,101 @@
+#include "binding_generator.h"
+
+#include <monopp/mono_domain.h>
+#include <monopp/mono_exception.h>
+#include <monopp/mono_jit.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+
+auto get_assembly_name(const std::string& path) -> std::string
+{
+	auto begin = path.find_last_of("/\\");
+	begin = begin == std::string::npos ? 0 : begin + 1;
+	auto end = path.find_last_of('.');
+	if(end == std::string::npos || end < begin)
+	{
+		end = path.size();
+	}
+	return path.substr(begin, end - begin);
+}
+
+// Leaves the header untouched when nothing changed so dependents do not rebuild.
+auto write_if_changed(const std::string& path, const std::string& content) -> bool
+{
+	{
+		std::ifstream in(path, std::ios::binary);
+		if(in)
+		{
+			std::ostringstream existing;
+			existing << in.rdbuf();
+			if(existing.str() == content)
+			{
+				return true;
+			}
+		}
+	}
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	out << content;
+	return bool(out);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	if(argc < 3)
+	{
+		std::cerr << "usage: monopp_bindgen <assembly> <output.h> [--namespace ns] [Type.Full.Name ...]"
+				  << std::endl;
+		return 1;
+	}
+
+	std::string assembly_path = argv[1];
+	std::string output_path = argv[2];
+	bindgen::generator_options options;
+	for(int i = 3; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if(arg == "--namespace" && i + 1 < argc)
+		{
+			options.output_namespace = argv[++i];
+		}
+		else
+		{
+			options.types.push_back(arg);
+		}
+	}
+
+	if(!mono::init())
+	{
+		return 1;
+	}
+
+	int result = 0;
+	try
+	{
+		mono::mono_domain domain("monopp_bindgen");
+		mono::mono_domain::set_current_domain(domain);
+
+		auto assembly = domain.get_assembly(assembly_path);
+		auto header = bindgen::generate_bindings(assembly, get_assembly_name(assembly_path), options);
+		if(!write_if_changed(output_path, header))
+		{
+			std::cerr << "could not write " << output_path << std::endl;
+			result = 1;
+		}
+	}
+	catch(const mono::mono_exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		result = 1;
+	}
+
+	mono::shutdown();
+	return result;
+}
@@ -1,4 +1,5 @@
 using System;
+using System.Collections.Generic;
 using System.Runtime.CompilerServices;
 
 namespace Tests
@@ -74,6 +75,14 @@ public static int somePropertyStatic
 			someFieldStatic = value;
 		}
 	}
+
+    public int someReadOnlyProperty
+	{
+		get
+		{
+			return someField;
+		}
+	}
 	
     static MonoppTest()
 	{
@@ -138,6 +147,15 @@ public static void Function5()
 		throw new Exception("Hello!");
 	}
 	
+    public static int Function7(int a)
+	{
+		if(a < 0)
+		{
+			throw new ArgumentException("Negative value!");
+		}
+		return a * 2;
+	}
+
     public static void Function6()
 	{
 		Tests.MyObject obj = new Tests.MyObject();
@@ -149,6 +167,160 @@ public static void Function6()
 }
 
 
+class DispatchBase
+{
+	public virtual int Update(int a)
+	{
+		return a;
+	}
+}
+
+class DispatchDerived1 : DispatchBase
+{
+	public override int Update(int a)
+	{
+		return a + 1;
+	}
+}
+
+interface IDispatchTarget
+{
+	int Update(int a);
+}
+
+class DispatchDerived2 : DispatchBase, IDispatchTarget
+{
+	public override int Update(int a)
+	{
+		return a + 2;
+	}
+}
+
+class DispatchDerived3 : DispatchDerived2
+{
+	public override int Update(int a)
+	{
+		return a + 3;
+	}
+}
+
+[AttributeUsage(AttributeTargets.All, AllowMultiple = true)]
+public class MarkerAttribute : Attribute
+{
+	public MarkerAttribute(int value)
+	{
+		Value = value;
+	}
+	public int Value;
+}
+
+public class StrongMarkerAttribute : MarkerAttribute
+{
+	public StrongMarkerAttribute(int value) : base(value)
+	{
+	}
+}
+
+[Marker(1)]
+class MarkedBase
+{
+	[StrongMarker(2)]
+	public int marked = 0;
+
+	[Marker(3)]
+	public int MarkedProperty
+	{
+		get { return marked; }
+	}
+
+	[Marker(4)]
+	public void MarkedMethod()
+	{
+	}
+}
+
+class MarkedDerived : MarkedBase
+{
+}
+
+enum SampleEnum : short
+{
+	Negative = -2,
+	Zero = 0,
+	One = 1,
+	Alias = 1,
+	Large = 300
+}
+
+
+public struct Labelled
+{
+	public int id;
+	public string label;
+}
+
+class FieldHolder
+{
+	public int number = 7;
+	public Vector2f position = new Vector2f(1, 2);
+	public string text = "text";
+	public object reference;
+	public Labelled tag;
+	public static int shared = 3;
+	public static string sharedText = "shared";
+	[ThreadStatic]
+	public static int perThread;
+
+	public List<int> numbers = new List<int> { 1, 2, 3 };
+	public List<string> names = new List<string> { "a", "b" };
+
+	public int Auto { get; set; }
+	public virtual int VirtualAuto { get; set; }
+	public static string StaticAuto { get; set; }
+
+	public static int GetShared()
+	{
+		return shared;
+	}
+
+	public static string GetSharedText()
+	{
+		return sharedText;
+	}
+
+	public int SumNumbers()
+	{
+		int sum = 0;
+		foreach(var n in numbers)
+		{
+			sum += n;
+		}
+		return sum;
+	}
+
+	public int GetNumber()
+	{
+		return number;
+	}
+
+	public string GetText()
+	{
+		return text;
+	}
+
+	public void SetTag(int id, string label)
+	{
+		tag.id = id;
+		tag.label = label;
+	}
+
+	public string GetTagLabel()
+	{
+		return tag.label;
+	}
+}
+
+
 public struct Vector2f  
 {
     public Vector2f(float _x, float _y)
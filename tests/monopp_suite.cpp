@@ -1,19 +1,41 @@
 #include "monopp_suite.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <thread>
 #include <monopp/mono_assembly.h>
+#include <monopp/mono_batch_invoker.h>
+#include <monopp/mono_binding.h>
 #include <monopp/mono_domain.h>
 #include <monopp/mono_field_invoker.h>
+#include <monopp/mono_field_set.h>
+#include <monopp/mono_gc_handle.h>
 #include <monopp/mono_internal_call.h>
 #include <monopp/mono_jit.h>
+#include <monopp/mono_list.h>
 #include <monopp/mono_method_invoker.h>
 #include <monopp/mono_object.h>
 #include <monopp/mono_property_invoker.h>
 #include <monopp/mono_string.h>
+#include <monopp/mono_thread.h>
 #include <monopp/mono_type.h>
+#include <monopp_bindgen/binding_generator.h>
+#include <mono_build_config.h>
 #include <suitepp/suite.hpp>
 
+BEGIN_MONO_INCLUDE
+#include <mono/metadata/appdomain.h>
+#include <mono/metadata/mono-gc.h>
+#include <mono/metadata/threads.h>
+END_MONO_INCLUDE
+
+// generated at build time by monopp_bindgen from tests/managed/tests.cs
+#include <tests_managed_bindings.h>
+
 namespace monopp
 {
 
@@ -124,7 +146,7 @@ void test_suite()
 			EXPECT(type.valid());
 
 			auto type2 = assembly.get_type("Tests.Nested.TestClassNested1");
-			EXPECT(type.valid());
+			EXPECT(type2.valid());
 
 			auto type3 = assembly.get_type("Tests.Nested.TestClassNested1.TestClassNested2");
 			EXPECT(type3.valid());
@@ -134,6 +156,710 @@ void test_suite()
 	};
 
 
+	TEST_CASE("get nested types through the type name index")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto before = assembly.get_type_index_stats();
+
+			auto nested = assembly.get_type("Tests.Nested.TestClassNested1.TestClassNested2");
+			EXPECT(nested.valid());
+			auto nested_plus = assembly.get_type("Tests.Nested.TestClassNested1+TestClassNested2");
+			EXPECT(nested_plus.get_internal_ptr() == nested.get_internal_ptr());
+			auto nested_split = assembly.get_type("Tests.Nested", "TestClassNested1+TestClassNested2");
+			EXPECT(nested_split.get_internal_ptr() == nested.get_internal_ptr());
+
+			auto missing = assembly.get_type("Tests.Nested.TestClassNested1.Missing");
+			EXPECT(!missing.valid());
+
+			auto after = assembly.get_type_index_stats();
+			EXPECT(after.hits == before.hits + 3);
+			EXPECT(after.misses == before.misses + 1);
+			EXPECT(after.size > 0);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("restore type name indexes from a metadata snapshot")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			const std::string nested_name = "Tests.Nested.TestClassNested1.TestClassNested2";
+			auto nested = assembly.get_type(nested_name);
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			auto cls = type.get_internal_ptr();
+			auto field_count = type.get_fields().size();
+			auto method_count = type.get_methods().size();
+			auto function1 = type.get_method("Function1", 1).get_internal_ptr();
+			const std::string path = "monopp_metadata_snapshot.bin";
+			EXPECT(mono::mono_assembly::save_metadata_snapshot(path, {assembly}));
+
+			mono::reset_assembly_cache();
+			mono::reset_type_cache();
+			EXPECT(mono::mono_assembly::load_metadata_snapshot(path) == 1);
+			EXPECT(assembly.get_type(nested_name).get_internal_ptr() == nested.get_internal_ptr());
+			EXPECT(assembly.get_type_index_stats().from_snapshot);
+
+			// member tables and name lookups of recorded types come from the tokens
+			EXPECT(mono::detail::find_snapshot_members(cls) != nullptr);
+			mono::mono_type warm(cls);
+			EXPECT(warm.get_fields().size() == field_count);
+			EXPECT(warm.get_methods().size() == method_count);
+			EXPECT(warm.get_method("Function1", 1).get_internal_ptr() == function1);
+			EXPECT_THROWS(warm.get_method("MissingMethod", 0));
+
+			// a damaged file is rejected as a whole
+			{
+				std::ofstream file(path, std::ios::binary | std::ios::app);
+				file << "trailing garbage";
+			}
+			EXPECT(mono::mono_assembly::load_metadata_snapshot(path) == 0);
+			EXPECT(mono::mono_assembly::load_metadata_snapshot("missing_snapshot.bin") == 0);
+			std::remove(path.c_str());
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("bind members through a binding context")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			auto function1 = type.get_method("Function1(int)");
+
+			// the tokens monopp_bindgen would have embedded
+			uint32_t type_token = 0;
+			for(uint32_t token = 0x02000001; assembly.get_type_by_token(token).valid(); ++token)
+			{
+				if(assembly.get_type_by_token(token).get_internal_ptr() == type.get_internal_ptr())
+				{
+					type_token = token;
+				}
+			}
+			uint32_t method_token = 0;
+			for(uint32_t token = 0x06000001; assembly.get_method_by_token(token).valid(); ++token)
+			{
+				if(assembly.get_method_by_token(token).get_internal_ptr() == function1.get_internal_ptr())
+				{
+					method_token = token;
+				}
+			}
+			EXPECT(type_token != 0);
+			EXPECT(method_token != 0);
+
+			mono::mono_binding_context context(assembly, assembly.get_mvid());
+			EXPECT(context.uses_tokens());
+			auto bound = context.get_type(type_token, "Tests.MonoppTest");
+			EXPECT(bound.get_internal_ptr() == type.get_internal_ptr());
+			auto method = context.get_method(bound, method_token, "Function1(int)");
+			EXPECT(method.get_internal_ptr() == function1.get_internal_ptr());
+			auto invoker = mono::make_thunk_invoker<int(int)>(method, false);
+			EXPECT(invoker(5) == 5 + 1337);
+
+			// an assembly rebuilt since the bindings were generated binds by name
+			mono::mono_binding_context rebuilt(assembly, "00000000-0000-0000-0000-000000000000");
+			EXPECT(!rebuilt.uses_tokens());
+			EXPECT(rebuilt.get_type(0, "Tests.MonoppTest").get_internal_ptr() == type.get_internal_ptr());
+			EXPECT(rebuilt.get_method(type, 0, "Function1(int)").get_internal_ptr() ==
+				   function1.get_internal_ptr());
+			EXPECT(rebuilt.get_field(type, 0, "someField").get_name() == "someField");
+			EXPECT_THROWS_AS(rebuilt.get_type(0, "Tests.DoesNotExist"), mono::mono_exception);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("generate bindings for a type")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			bindgen::generator_options options;
+			options.output_namespace = "generated";
+			options.types = {"Tests.MonoppTest"};
+			auto header = bindgen::generate_bindings(assembly, "tests_managed", options);
+
+			auto contains = [&](const std::string& text) { return header.find(text) != std::string::npos; };
+			EXPECT(contains("namespace generated"));
+			EXPECT(contains("namespace Tests"));
+			EXPECT(contains("class MonoppTest"));
+			EXPECT(contains("tests_managed_mvid = \"" + assembly.get_mvid() + "\""));
+			EXPECT(contains("static auto Function1(std::int32_t a) -> std::int32_t"));
+			EXPECT(contains("static auto get_someField(const mono::mono_object& self) -> std::int32_t"));
+			EXPECT(contains("static void set_somePropertyStatic(std::int32_t value)"));
+			EXPECT(contains("static auto get_someReadOnlyProperty(const mono::mono_object& self) -> std::int32_t"));
+			EXPECT(!contains("set_someReadOnlyProperty"));
+			EXPECT(contains("\"Function1(int)\"), !context.uses_tokens()))"));
+			EXPECT(contains("inline void bind_tests_managed(const mono::mono_assembly& assembly)"));
+			EXPECT(contains("inline void unbind_tests_managed()"));
+			// private methods are not bound
+			EXPECT(!contains("Method1"));
+
+			options.types = {"Tests.DoesNotExist"};
+			EXPECT_THROWS_AS(bindgen::generate_bindings(assembly, "tests_managed", options), mono::mono_exception);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("call through bindings generated at build time")
+	{
+		auto expression = [&]()
+		{
+			// built from the same source but not the same build, so binding
+			// falls back to names and checks the signatures
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			EXPECT(assembly.get_mvid() != test_bindings::tests_managed_mvid);
+
+			using test_bindings::Tests::MonoppTest;
+			EXPECT(!MonoppTest::is_bound());
+			test_bindings::bind_tests_managed(assembly);
+			EXPECT(MonoppTest::is_bound());
+			EXPECT(MonoppTest::get_type().get_internal_ptr() ==
+				   assembly.get_type("Tests", "MonoppTest").get_internal_ptr());
+
+			EXPECT(MonoppTest::Function1(5) == 5 + 1337);
+			EXPECT(MonoppTest::Function4("x") == "The string value was: x");
+			auto obj = MonoppTest::get_type().new_instance();
+			MonoppTest::set_someField(obj, 55);
+			EXPECT(MonoppTest::get_someField(obj) == 55);
+			EXPECT(MonoppTest::get_someProperty(obj) == 55);
+
+			test_bindings::unbind_tests_managed();
+			EXPECT(!MonoppTest::is_bound());
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("resolve types through the domain cache")
+	{
+		auto expression = [&]()
+		{
+			domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = domain.get_type("Tests", "MonoppTest");
+			EXPECT(type.valid());
+			EXPECT(domain.get_type("Tests", "MonoppTest").get_internal_ptr() == type.get_internal_ptr());
+			EXPECT(domain.get_type("Tests.MonoppTest").get_internal_ptr() == type.get_internal_ptr());
+
+			// misses are remembered until a new assembly gets loaded
+			EXPECT(!domain.get_type("Tests", "DoesNotExist").valid());
+			EXPECT(!domain.get_type("Tests", "DoesNotExist").valid());
+
+			EXPECT(!domain.get_type("Monopp.Core", "NativeObject").valid());
+			domain.get_assembly(DATA_DIR "monort_managed.dll");
+			EXPECT(domain.get_type("Monopp.Core", "NativeObject").valid());
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("query types through the inheritance index")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto base = assembly.get_type("Tests", "DispatchBase");
+			auto target = assembly.get_type("Tests", "IDispatchTarget");
+			EXPECT(base.valid());
+			EXPECT(target.valid());
+			EXPECT(target.is_interface());
+
+			EXPECT(assembly.get_types_derived_from(base).size() == 4);
+			EXPECT(assembly.get_direct_subtypes(base).size() == 2);
+			EXPECT(assembly.get_types_implementing(target).size() == 2);
+			for(const auto& type : assembly.get_types_implementing(target))
+			{
+				EXPECT(type.is_derived_from(base));
+				EXPECT(type.is_derived_from(target));
+			}
+
+			// the index agrees with checking every type one by one
+			auto types = assembly.get_types();
+			auto object = mono::mono_assembly::get_corlib().get_type("System", "Object");
+			for(const auto& candidate : {base, target, object, assembly.get_type("Tests", "MonoppTest")})
+			{
+				size_t expected = 0;
+				for(const auto& type : types)
+				{
+					expected += type.is_derived_from(candidate) ? 1 : 0;
+				}
+				auto derived = assembly.get_types_derived_from(candidate);
+				EXPECT(derived.size() == expected);
+				for(const auto& type : derived)
+				{
+					EXPECT(type.is_derived_from(candidate));
+				}
+			}
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("share member tables between queries")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+
+			const auto& fields = type.get_fields();
+			EXPECT(&fields == &mono::mono_type(type.get_internal_ptr()).get_fields());
+			EXPECT(!fields.empty());
+			for(const auto& field : fields)
+			{
+				EXPECT(field.get_internal_ptr() == type.get_field(field.get_name()).get_internal_ptr());
+			}
+			for(const auto& property : type.get_properties())
+			{
+				EXPECT(property.get_internal_ptr() ==
+					   type.get_property(property.get_name()).get_internal_ptr());
+			}
+
+			auto derived = assembly.get_type("Tests", "DispatchDerived3");
+			auto base = derived.get_base_type();
+			const auto& methods = derived.get_methods(true);
+			EXPECT(&methods == &derived.get_methods(true));
+			EXPECT(methods.size() == base.get_methods(true).size() + derived.get_methods().size());
+			EXPECT(methods.back().get_internal_ptr() == derived.get_methods().back().get_internal_ptr());
+			EXPECT(std::any_of(derived.get_methods().begin(), derived.get_methods().end(),
+							   [](const mono::mono_method& method) { return method.get_name() == "Update"; }));
+
+			EXPECT(mono::mono_type().get_fields(true).empty());
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("query attributes through the attribute index")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto marker = assembly.get_type("Tests", "MarkerAttribute");
+			auto strong = assembly.get_type("Tests", "StrongMarkerAttribute");
+			auto base = assembly.get_type("Tests", "MarkedBase");
+			auto derived = assembly.get_type("Tests", "MarkedDerived");
+			auto value = mono::make_field_invoker<int>(marker.get_field("Value"));
+
+			EXPECT(base.has_attribute(marker));
+			EXPECT(!base.has_attribute(strong));
+			EXPECT(!derived.has_attribute(marker));
+			EXPECT(derived.has_attribute(marker, true));
+			EXPECT(derived.get_attributes(true).size() == 1);
+			EXPECT(derived.get_attributes().empty());
+			EXPECT(value.get_value(derived.get_attribute(marker, true)) == 1);
+
+			// derived attribute classes match their base
+			auto field = base.get_field("marked");
+			EXPECT(field.has_attribute(marker));
+			EXPECT(field.has_attribute(strong));
+			EXPECT(field.has_attribute("StrongMarkerAttribute"));
+			EXPECT(field.has_attribute_fullname("Tests.StrongMarkerAttribute"));
+			EXPECT(!field.has_attribute("MarkerAttribute"));
+			EXPECT(field.get_attribute(marker).get_type().get_internal_ptr() == strong.get_internal_ptr());
+			EXPECT(value.get_value(field.get_attribute_fullname("Tests.StrongMarkerAttribute")) == 2);
+
+			auto property = base.get_property("MarkedProperty");
+			EXPECT(property.has_attribute(marker));
+			EXPECT(value.get_value(property.get_attribute("MarkerAttribute")) == 3);
+
+			auto method = base.get_method("MarkedMethod()");
+			EXPECT(method.has_attribute(marker));
+			EXPECT(method.get_attributes().size() == 1);
+			EXPECT(value.get_value(method.get_attribute(marker)) == 4);
+
+			EXPECT(!assembly.get_type("Tests", "MonoppTest").has_attribute(marker, true));
+			EXPECT(!assembly.get_type("Tests", "MonoppTest").get_attribute(marker, true).valid());
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("read enum constants from metadata")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "SampleEnum");
+			EXPECT(type.is_enum());
+
+			// same order as System.Enum.GetValues: unsigned, negative values last
+			auto values = type.get_enum_values<int16_t>();
+			EXPECT(values.size() == 5);
+			EXPECT(values.front().first == 0 && values.front().second == "Zero");
+			EXPECT(values[1].second == "One" && values[2].second == "Alias");
+			EXPECT(values[3].first == 300);
+			EXPECT(values.back().first == -2 && values.back().second == "Negative");
+
+			EXPECT(type.get_enum_name(int16_t(-2)) && *type.get_enum_name(int16_t(-2)) == "Negative");
+			EXPECT(*type.get_enum_name(int16_t(1)) == "One");
+			EXPECT(type.get_enum_name(int16_t(7)) == nullptr);
+
+			int16_t value = 0;
+			EXPECT(type.get_enum_value("Large", value) && value == 300);
+			EXPECT(type.get_enum_value("Negative", value) && value == -2);
+			EXPECT(!type.get_enum_value("Missing", value));
+
+			EXPECT(assembly.get_type("Tests", "MonoppTest").get_enum_values<int32_t>().empty());
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("access instance fields at their offset")
+	{
+		auto expression = [&]()
+		{
+			struct vec2
+			{
+				float x;
+				float y;
+			};
+
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+			auto obj = type.new_instance();
+
+			auto number = mono::make_field_invoker<int32_t>(type, "number");
+			EXPECT(number.is_direct());
+			EXPECT(number.get_value(obj) == 7);
+			number.set_value(obj, 42);
+			EXPECT(mono::make_method_invoker<int()>(type, "GetNumber")(obj) == 42);
+
+			auto position = mono::make_field_invoker<vec2>(type, "position");
+			EXPECT(position.is_direct());
+			EXPECT(position.get_value(obj).y == 2.0f);
+			position.set_value(obj, vec2{3.0f, 4.0f});
+			EXPECT(position.get_value(obj).x == 3.0f);
+
+			// references are stored through the write barrier
+			auto text = mono::make_field_invoker<std::string>(type, "text");
+			EXPECT(text.is_direct());
+			text.set_value(obj, "changed");
+			EXPECT(mono::make_method_invoker<std::string()>(type, "GetText")(obj) == "changed");
+
+			auto reference = mono::make_field_invoker<mono::mono_object>(type, "reference");
+			EXPECT(reference.is_direct());
+			EXPECT(!reference.get_value(obj).valid());
+			auto target = type.new_instance();
+			reference.set_value(obj, target);
+			EXPECT(reference.get_value(obj).get_internal_ptr() == target.get_internal_ptr());
+
+			// mismatched layouts keep the runtime path
+			EXPECT(!mono::make_field_invoker<int64_t>(type, "number").is_direct());
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("access static fields through the static data")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+
+			// without the static data the values still round trip through the runtime
+			constexpr bool direct = MONOPP_HAS_VTABLE_STATIC_FIELD_DATA != 0;
+			auto shared = mono::make_field_invoker<int32_t>(type, "shared");
+			EXPECT(shared.is_direct() == direct);
+			EXPECT(shared.get_value() == 3);
+			shared.set_value(21);
+			EXPECT(mono::make_method_invoker<int()>(type, "GetShared")() == 21);
+
+			auto shared_text = mono::make_field_invoker<std::string>(type, "sharedText");
+			EXPECT(shared_text.is_direct() == direct);
+			EXPECT(shared_text.get_value() == "shared");
+			shared_text.set_value("updated");
+			EXPECT(mono::make_method_invoker<std::string()>(type, "GetSharedText")() == "updated");
+
+			// thread statics have no fixed address
+			auto per_thread = mono::make_field_invoker<int32_t>(type, "perThread");
+			EXPECT(!per_thread.is_direct());
+			per_thread.set_value(5);
+			EXPECT(per_thread.get_value() == 5);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("snapshot and restore a field set")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+			mono::mono_field_set fields(type, {"number", "position", "text", "reference", "tag"});
+
+			const auto& entries = fields.get_entries();
+			EXPECT(entries.size() == 5);
+			EXPECT(!entries[0].needs_barrier());
+			EXPECT(!entries[1].needs_barrier());
+			EXPECT(entries[2].kind == mono::mono_field_set::field_kind::reference);
+			EXPECT(entries[3].kind == mono::mono_field_set::field_kind::reference);
+			EXPECT(entries[4].kind == mono::mono_field_set::field_kind::value_with_references);
+			EXPECT(fields.has_references());
+			EXPECT(entries[1].buffer_offset % 4 == 0);
+			EXPECT(entries[2].buffer_offset % alignof(void*) == 0);
+
+			auto source = type.new_instance();
+			auto target = type.new_instance();
+			auto number = mono::make_field_invoker<int32_t>(type, "number");
+			auto text = mono::make_field_invoker<std::string>(type, "text");
+			auto reference = mono::make_field_invoker<mono::mono_object>(type, "reference");
+			number.set_value(source, 11);
+			text.set_value(source, "copied");
+			reference.set_value(source, source);
+
+			std::vector<std::uint64_t> buffer((fields.get_buffer_size() + 7) / 8);
+			fields.snapshot(source, buffer.data());
+			fields.restore(target, buffer.data());
+			EXPECT(number.get_value(target) == 11);
+			EXPECT(text.get_value(target) == "copied");
+			EXPECT(reference.get_value(target).get_internal_ptr() == source.get_internal_ptr());
+
+			// objects of another class or none at all are rejected
+			auto other = assembly.get_type("Tests", "MonoppTest").new_instance();
+			EXPECT_THROWS_AS(fields.snapshot(other, buffer.data()), mono::mono_exception);
+			fields.snapshot(source, buffer.data());
+			EXPECT_THROWS_AS(fields.restore(other, buffer.data()), mono::mono_exception);
+			EXPECT_THROWS_AS(fields.restore(mono::mono_object(), buffer.data()), mono::mono_exception);
+			fields.release(buffer.data());
+
+			EXPECT_THROWS_AS(mono::mono_field_set(type, {"shared"}), mono::mono_exception);
+			EXPECT_THROWS_AS(mono::mono_field_set(type, {"missing"}), mono::mono_exception);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("restore a field set after a collection")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+			mono::mono_field_set fields(type, {"text", "reference", "tag"});
+			auto number = mono::make_field_invoker<int32_t>(type, "number");
+			auto text = mono::make_field_invoker<std::string>(type, "text");
+			auto reference = mono::make_field_invoker<mono::mono_object>(type, "reference");
+			auto set_tag = mono::make_method_invoker<void(int, std::string)>(type, "SetTag");
+			auto get_tag_label = mono::make_method_invoker<std::string()>(type, "GetTagLabel");
+
+			auto source = type.new_instance();
+			{
+				// only the source field references these, nursery objects
+				// that a minor collection moves
+				auto referenced = type.new_instance();
+				number.set_value(referenced, 99);
+				reference.set_value(source, referenced);
+				text.set_value(source, "survives");
+				set_tag(source, 1, "label");
+			}
+
+			std::vector<std::uint64_t> buffer((fields.get_buffer_size() + 7) / 8);
+			fields.snapshot(source, buffer.data());
+			auto target = type.new_instance();
+			source = mono::mono_object();
+			mono_gc_collect(0);
+			mono_gc_collect(mono_gc_max_generation());
+
+			fields.restore(target, buffer.data());
+			EXPECT(text.get_value(target) == "survives");
+			EXPECT(number.get_value(reference.get_value(target)) == 99);
+			EXPECT(get_tag_label(target) == "label");
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("gather and scatter a field across objects")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+			std::vector<mono::mono_object> objects;
+			for(size_t i = 0; i < 100; ++i)
+			{
+				objects.emplace_back(type.new_instance());
+			}
+
+			auto number = mono::make_field_invoker<int32_t>(type, "number");
+			std::vector<int32_t> values(objects.size());
+			for(size_t i = 0; i < values.size(); ++i)
+			{
+				values[i] = int32_t(i * 3);
+			}
+			number.scatter(objects, values.data());
+			EXPECT(number.get_value(objects[10]) == 30);
+
+			std::vector<int32_t> gathered(objects.size());
+			number.gather(objects, gathered.data());
+			EXPECT(gathered == values);
+
+			std::vector<std::unique_ptr<mono::mono_scoped_gc_handle>> pins;
+			std::vector<uint32_t> handles;
+			for(const auto& obj : objects)
+			{
+				pins.emplace_back(new mono::mono_scoped_gc_handle(obj));
+				handles.push_back(pins.back()->get_handle());
+			}
+			auto text = mono::make_field_invoker<std::string>(type, "text");
+			std::vector<std::string> texts(objects.size(), "scattered");
+			text.scatter_handles(handles.data(), handles.size(), texts.data());
+			std::vector<std::string> gathered_texts(objects.size());
+			text.gather_handles(handles.data(), handles.size(), gathered_texts.data());
+			EXPECT(gathered_texts == texts);
+
+			// a null object in the middle throws instead of being dereferenced
+			objects[50] = mono::mono_object();
+			EXPECT_THROWS_AS(number.gather(objects, gathered.data()), mono::mono_exception);
+			EXPECT_THROWS_AS(number.scatter(objects, values.data()), mono::mono_exception);
+			EXPECT_THROWS_AS(text.gather(objects, gathered_texts.data()), mono::mono_exception);
+			handles[50] = 0;
+			EXPECT_THROWS_AS(number.gather_handles(handles.data(), handles.size(), gathered.data()),
+							 mono::mono_exception);
+
+			// a thread static goes through the runtime and ignores the objects
+			auto per_thread = mono::make_field_invoker<int32_t>(type, "perThread");
+			EXPECT(!per_thread.is_direct());
+			per_thread.set_value(7);
+			per_thread.gather(objects, gathered.data());
+			EXPECT(std::all_of(gathered.begin(), gathered.end(), [](int32_t v) { return v == 7; }));
+			per_thread.scatter(objects, values.data());
+			EXPECT(per_thread.get_value() == values.back());
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("read and write List<T> through its backing array")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+			auto obj = type.new_instance();
+			auto lists = mono::make_field_invoker<mono::mono_object>(type, "numbers");
+
+			mono::mono_list<int32_t> numbers(lists.get_value(obj));
+			EXPECT(numbers.size() == 3);
+			EXPECT(numbers.get(1) == 2);
+			numbers.set(1, 20);
+			EXPECT(mono::make_method_invoker<int()>(type, "SumNumbers")(obj) == 24);
+			EXPECT(numbers.to_vector() == std::vector<int32_t>({1, 20, 3}));
+			EXPECT(numbers.to_list().back() == 3);
+			// past the end goes to the indexer, which throws
+			EXPECT_THROWS(numbers.get(3));
+
+			mono::mono_list<mono::mono_object> names(
+				mono::make_field_invoker<mono::mono_object>(type, "names").get_value(obj));
+			EXPECT(names.size() == 2);
+			EXPECT(mono::mono_string(names.get(0)).as_utf8() == "a");
+			names.set(1, mono::mono_string(domain, "z"));
+			auto all = names.to_vector();
+			EXPECT(all.size() == 2);
+			EXPECT(mono::mono_string(all[1]).as_utf8() == "z");
+
+			// a list that wraps no object throws instead of reading its class
+			mono::mono_list<int32_t> invalid{mono::mono_object()};
+			EXPECT_THROWS_AS(invalid.size(), mono::mono_exception);
+			EXPECT_THROWS_AS(invalid.get(0), mono::mono_exception);
+			EXPECT_THROWS_AS(invalid.set(0, 1), mono::mono_exception);
+			EXPECT_THROWS_AS(invalid.add_range(std::vector<int32_t>({1})), mono::mono_exception);
+			EXPECT_THROWS_AS(invalid.to_vector(), mono::mono_exception);
+
+			// T has no managed class to deduce and no element type is given
+			EXPECT_THROWS_AS(mono::mono_list<mono::mono_object>(std::vector<mono::mono_object>(1)),
+							 mono::mono_exception);
+			mono::mono_list<int32_t> created(std::vector<int32_t>({4, 5}));
+			EXPECT(created.to_vector() == std::vector<int32_t>({4, 5}));
+			EXPECT(!mono::mono_converter<mono::mono_list<int32_t>>::from_mono(nullptr).valid());
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("append to a List<T> in bulk")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+			auto obj = type.new_instance();
+			auto sum = mono::make_method_invoker<int()>(type, "SumNumbers");
+
+			mono::mono_list<int32_t> numbers(
+				mono::make_field_invoker<mono::mono_object>(type, "numbers").get_value(obj));
+			numbers.add_range(std::vector<int32_t>(1000, 1));
+			EXPECT(numbers.size() == 1003);
+			EXPECT(numbers.get(1002) == 1);
+			// enumerating checks the list is consistent after the direct writes
+			EXPECT(sum(obj) == 1006);
+
+			numbers.set(std::vector<int32_t>({7, 8}), numbers.get_element_type());
+			EXPECT(numbers.to_vector() == std::vector<int32_t>({7, 8}));
+			EXPECT(sum(obj) == 15);
+
+			mono::mono_list<mono::mono_object> names(
+				mono::make_field_invoker<mono::mono_object>(type, "names").get_value(obj));
+			std::vector<mono::mono_object> more;
+			for(int i = 0; i < 100; ++i)
+			{
+				more.emplace_back(mono::mono_string(domain, std::to_string(i)));
+			}
+			names.add_range(more);
+			EXPECT(names.size() == 102);
+			EXPECT(mono::mono_string(names.get(101)).as_utf8() == "99");
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("keep metadata of live wrappers when another domain unloads")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			auto method = type.get_method("Function1", 1);
+			auto fullname = type.get_fullname();
+
+			{
+				mono::mono_domain other("unloaded_domain");
+				mono::mono_domain::set_current_domain(other);
+				auto other_assembly = other.get_assembly(DATA_DIR "tests_managed.dll");
+				auto other_type = other_assembly.get_type("Tests", "MonoppTest");
+				EXPECT(other_type.get_fullname() == fullname);
+				mono::mono_domain::set_current_domain(domain);
+			}
+
+			// the caches were cleared, the wrappers still read their own records
+			EXPECT(type.get_fullname() == fullname);
+			EXPECT(method.get_name() == "Function1");
+			EXPECT(mono::mono_type(type.get_internal_ptr()).get_fullname() == fullname);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("free retired cache generations once their domains unload")
+	{
+		auto expression = [&]()
+		{
+			mono::mono_meta_cache<int, int> cache;
+			cache.emplace(1, 10);
+			auto value = cache.find(1);
+
+			// the suite's domain outlives the retire, so the generation is kept
+			auto serial = mono::detail::enter_domain_epoch();
+			cache.retire();
+			mono::detail::leave_domain_epoch(serial);
+			EXPECT(cache.retired_count() == 1);
+			EXPECT(cache.find(1) == nullptr);
+			EXPECT(*value == 10);
+
+			// nothing to retire, the generation still waits for the suite's domain
+			cache.retire();
+			EXPECT(cache.retired_count() == 1);
+
+			cache.emplace(2, 20);
+			cache.clear();
+			EXPECT(cache.retired_count() == 0);
+			EXPECT(cache.size() == 0);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
 	TEST_CASE("get valid method")
 	{
 		auto expression = [&]()
@@ -264,6 +990,62 @@ void test_suite()
 		EXPECT_NOTHROWS(expression());
 	};
 
+	TEST_CASE("get a getter-only property")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			auto obj = type.new_instance();
+
+			auto read_only = mono::make_property_invoker<int>(type.get_property("someReadOnlyProperty"));
+			EXPECT(read_only.get_value(obj) == 12);
+			EXPECT_THROWS_AS(read_only.set_value(obj, 1), mono::mono_exception);
+
+			// the exception info reads the getter-only Message and StackTrace
+			auto function5 = mono::make_method_invoker<void()>(type, "Function5");
+			EXPECT_THROWS_AS(function5(), mono::mono_thunk_exception);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("access auto-properties through their backing field")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+			auto obj = type.new_instance();
+
+			auto automatic = mono::make_property_invoker<int>(type.get_property("Auto"));
+			EXPECT(automatic.is_direct());
+			automatic.set_value(obj, 9);
+			EXPECT(automatic.get_value(obj) == 9);
+			EXPECT(mono::make_method_invoker<int()>(type, "get_Auto")(obj) == 9);
+
+			// an override could run code, so virtual accessors are called
+			auto overridable = mono::make_property_invoker<int>(type.get_property("VirtualAuto"));
+			EXPECT(!overridable.is_direct());
+			overridable.set_value(obj, 4);
+			EXPECT(overridable.get_value(obj) == 4);
+
+			auto static_auto = mono::make_property_invoker<std::string>(type.get_property("StaticAuto"));
+			EXPECT(static_auto.is_direct() == (MONOPP_HAS_VTABLE_STATIC_FIELD_DATA != 0));
+			static_auto.set_value("static");
+			EXPECT(mono::make_method_invoker<std::string()>(type, "get_StaticAuto")() == "static");
+
+			// hand written accessors keep going through the cached thunks
+			auto monopp_type = assembly.get_type("Tests", "MonoppTest");
+			auto written = mono::make_property_invoker<int>(monopp_type.get_property("someProperty"));
+			EXPECT(!written.is_direct());
+			auto copy = written;
+			auto instance = monopp_type.new_instance();
+			copy.set_value(instance, 31);
+			EXPECT(written.get_value(instance) == 31);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
 	TEST_CASE("get invalid property")
 	{
 		auto expression = [&]()
@@ -351,6 +1133,480 @@ void test_suite()
 		EXPECT_NOTHROWS(expression());
 	};
 
+	TEST_CASE("call static method via unmanaged thunk")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			auto method_thunk = mono::make_thunk_invoker<int(int)>(type, "Function1");
+			EXPECT(method_thunk.uses_unmanaged_thunk());
+			const auto number = 1000;
+			auto result = method_thunk(number);
+			EXPECT(number + 1337 == result);
+
+			auto string_thunk = mono::make_thunk_invoker<std::string(std::string)>(type, "Function4");
+			auto expected_string = std::string("Hello!");
+			EXPECT(string_thunk(expected_string) == std::string("The string value was: " + expected_string));
+
+			auto throwing_thunk = mono::make_thunk_invoker<void()>(type, "Function5");
+			EXPECT_THROWS_AS(throwing_thunk(), mono::mono_thunk_exception);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("call member method via unmanaged thunk")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			auto obj = type.new_instance();
+			auto method_thunk = mono::make_thunk_invoker<std::string(std::string, int)>(type, "Method5");
+			auto result = method_thunk(obj, "test", 5);
+			EXPECT(result == std::string("Return Value: test"));
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("call virtual method through inline cache")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto base_type = assembly.get_type("Tests", "DispatchBase");
+			auto obj1 = assembly.get_type("Tests", "DispatchDerived1").new_instance();
+			auto obj2 = assembly.get_type("Tests", "DispatchDerived2").new_instance();
+
+			auto method_thunk = mono::make_method_invoker<int(int)>(base_type, "Update");
+			EXPECT(method_thunk(obj1, 10) == 11);
+			EXPECT(method_thunk(obj2, 10) == 12);
+			EXPECT(method_thunk(obj1, 10) == 11);
+
+			const auto& stats = method_thunk.get_dispatch_stats();
+			EXPECT(stats.misses == 2);
+			EXPECT(stats.hits == 1);
+
+			auto unmanaged_thunk = mono::make_thunk_invoker<int(int)>(base_type, "Update");
+			EXPECT(unmanaged_thunk(obj1, 10) == 11);
+			EXPECT(unmanaged_thunk(obj2, 10) == 12);
+			EXPECT(unmanaged_thunk(obj2, 10) == 12);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("share a virtual invoker between threads")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto base_type = assembly.get_type("Tests", "DispatchBase");
+			auto obj1 = assembly.get_type("Tests", "DispatchDerived1").new_instance();
+			auto obj2 = assembly.get_type("Tests", "DispatchDerived2").new_instance();
+			auto method_thunk = mono::make_thunk_invoker<int(int)>(base_type, "Update");
+
+			constexpr size_t thread_count = 4;
+			std::atomic<size_t> mismatches{0};
+			std::vector<std::thread> threads;
+			for(size_t t = 0; t < thread_count; ++t)
+			{
+				threads.emplace_back(
+					[&]()
+					{
+						mono::mono_thread_scope scope;
+						for(int i = 0; i < 500; ++i)
+						{
+							const auto& obj = i % 2 ? obj1 : obj2;
+							if(method_thunk(obj, 10) != (i % 2 ? 11 : 12))
+							{
+								mismatches++;
+							}
+						}
+					});
+			}
+			for(auto& thread : threads)
+			{
+				thread.join();
+			}
+			EXPECT(mismatches == 0);
+
+			auto stats = method_thunk.get_dispatch_stats();
+			EXPECT(stats.hits + stats.misses == thread_count * 500);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("call method in batches")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			auto batch = mono::make_batch_invoker<int(int)>(type, "Function7");
+
+			auto result = batch({std::make_tuple(1), std::make_tuple(-1), std::make_tuple(3)});
+			EXPECT(result.values.size() == 3);
+			EXPECT(result.values[0] == 2);
+			EXPECT(result.values[2] == 6);
+			EXPECT(result.errors.size() == 1);
+			EXPECT(result.errors.front().index == 1);
+
+			auto base_type = assembly.get_type("Tests", "DispatchBase");
+			std::vector<mono::mono_object> objects = {
+				assembly.get_type("Tests", "DispatchDerived1").new_instance(),
+				assembly.get_type("Tests", "DispatchDerived2").new_instance()};
+
+			auto update_batch = mono::make_batch_invoker(mono::make_thunk_invoker<int(int)>(base_type, "Update"));
+			auto updates = update_batch(objects, 10);
+			EXPECT(updates.succeeded());
+			EXPECT(updates.values[0] == 11);
+			EXPECT(updates.values[1] == 12);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("check signatures by type identity")
+	{
+		auto expression = [&]()
+		{
+			struct unregistered_type
+			{
+			};
+
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			auto method = type.get_method("Function1", 1);
+
+			EXPECT(mono::has_compatible_signature<int(int)>(method));
+			// a void C++ return discards the managed result
+			EXPECT(mono::has_compatible_signature<void(int)>(method));
+			auto discard = mono::make_thunk_invoker<void(int)>(method);
+			EXPECT(!discard.uses_unmanaged_thunk());
+			discard(1);
+			EXPECT(!mono::has_compatible_signature<int(float)>(method));
+			EXPECT(!mono::has_compatible_signature<std::string(int)>(method));
+
+			// unknown types are accepted until they get bound to a class
+			EXPECT(mono::has_compatible_signature<int(unregistered_type)>(method));
+			mono::register_type_class<unregistered_type>(type);
+			EXPECT(!mono::has_compatible_signature<int(unregistered_type)>(method));
+			mono::get_type_class<unregistered_type>() = nullptr;
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("resolve method through resolution cache")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+
+			auto method1 = mono::make_method_invoker<int(int)>(type, "Function1");
+			auto cached = mono::find_cached_method(type, "Function1", mono::types::id<int(int)>());
+			EXPECT(cached.valid());
+			EXPECT(cached.get_internal_ptr() == method1.get_internal_ptr());
+
+			auto method2 = mono::make_method_invoker<int(int)>(type, "Function1");
+			EXPECT(method2.get_internal_ptr() == method1.get_internal_ptr());
+			EXPECT(method2(5) == method1(5));
+
+			auto uncached = mono::find_cached_method(type, "Function1", mono::types::id<void(int)>());
+			EXPECT(!uncached.valid());
+
+			auto methods_before = type.get_methods().size();
+			auto method_ptr = method1.get_internal_ptr();
+			mono::reset_method_cache();
+			// the wrappers made so far are invalid now, only their handles are kept
+			mono::mono_type fresh(type.get_internal_ptr());
+			EXPECT(!mono::find_cached_method(fresh, "Function1", mono::types::id<int(int)>()).valid());
+			// the type's member table is rebuilt along with the methods
+			const auto& methods = fresh.get_methods();
+			EXPECT(methods.size() == methods_before);
+			EXPECT(!methods.front().get_name().empty());
+			auto method3 = mono::make_method_invoker<int(int)>(fresh, "Function1");
+			EXPECT(method3.get_internal_ptr() == method_ptr);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("access fields and lists from worker threads")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "FieldHolder");
+			auto obj = type.new_instance();
+			auto numbers = mono::make_field_invoker<mono::mono_object>(type, "numbers");
+
+			// every entry point attaches the worker, not just method invokers
+			size_t count = 0;
+			std::string text;
+			bool attached = false;
+			std::thread worker(
+				[&]()
+				{
+					count = mono::mono_list<int32_t>(numbers.get_value(obj)).size();
+					text = mono::mono_string(domain, "worker").as_utf8();
+					attached = mono::is_thread_attached();
+				});
+			worker.join();
+			EXPECT(count == 3);
+			EXPECT(text == "worker");
+			EXPECT(attached);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("call methods from worker threads")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			auto method = mono::make_method_invoker<int(int)>(type, "Function7");
+			auto before = mono::get_thread_attach_stats();
+
+			// lazily attached by the invoker, detached on thread exit
+			int lazy_result = 0;
+			std::thread lazy_worker([&]() { lazy_result = method(21); });
+			lazy_worker.join();
+			EXPECT(lazy_result == 42);
+
+			// attached for the lifetime of the scope only
+			int scoped_result = 0;
+			bool attached_in_scope = false;
+			bool attached_after_scope = true;
+			std::thread scoped_worker(
+				[&]()
+				{
+					{
+						mono::mono_thread_scope scope;
+						attached_in_scope = scope.owns_attachment() && mono::is_thread_attached();
+						scoped_result = method(2);
+					}
+					attached_after_scope = mono::is_thread_attached();
+				});
+			scoped_worker.join();
+			EXPECT(scoped_result == 4);
+			EXPECT(attached_in_scope);
+			EXPECT(!attached_after_scope);
+
+			// the main thread was attached by the domain and is left alone
+			mono::ensure_thread_attached();
+			EXPECT(!mono::is_thread_attached());
+
+			auto after = mono::get_thread_attach_stats();
+			EXPECT(after.attached == before.attached + 2);
+			EXPECT(after.detached == before.detached + 2);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("make the first calls of an unchecked invoker from many threads")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			// no signature check, so nothing has read the parameters yet
+			auto invoker = mono::make_thunk_invoker<int(int)>(type.get_method("Function7", 1), false);
+			EXPECT(invoker.get_param_types().size() == 1);
+
+			std::atomic<size_t> mismatches{0};
+			std::vector<std::thread> threads;
+			for(int t = 0; t < 8; ++t)
+			{
+				threads.emplace_back(
+					[&, t]()
+					{
+						mono::mono_thread_scope scope;
+						mismatches += invoker(t) == t * 2 ? 0 : 1;
+					});
+			}
+			for(auto& thread : threads)
+			{
+				thread.join();
+			}
+			EXPECT(mismatches == 0);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("rebind threads attached by someone else")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			auto method = mono::make_method_invoker<int(int)>(type, "Function7");
+			auto target = mono_domain_get();
+
+			bool moved = false;
+			bool owned_while_foreign = true;
+			bool owned_after_detach = false;
+			int result = 0;
+			std::thread worker(
+				[&]()
+				{
+					// attached to another domain behind the registry's back
+					auto thread = mono_thread_attach(mono_get_root_domain());
+					mono::ensure_thread_attached();
+					moved = mono_domain_get() == target;
+					owned_while_foreign = mono::is_thread_attached();
+
+					// its owner lets go, so the registry takes over
+					mono_thread_detach(thread);
+					result = method(5);
+					owned_after_detach = mono::is_thread_attached() && mono_domain_get() == target;
+				});
+			worker.join();
+			EXPECT(moved);
+			EXPECT(!owned_while_foreign);
+			EXPECT(owned_after_detach);
+			EXPECT(result == 10);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("hash type names")
+	{
+		constexpr auto literal_hash = mono::mono_type::get_hash("Tests.MonoppTest");
+		static_assert(literal_hash != 0, "type name hashes should fold at compile time");
+
+		auto expression = [&]()
+		{
+			// bit by bit reference of the same crc
+			auto reference = [](const std::string& str)
+			{
+				std::uint64_t crc = 0;
+				for(auto c : str)
+				{
+					crc ^= std::uint8_t(c);
+					for(int bit = 0; bit < 8; ++bit)
+					{
+						crc = (crc >> 1) ^ ((crc & 1) ? 0xc96c5795d7870f42ull : 0);
+					}
+				}
+				return size_t(crc);
+			};
+
+			std::string name;
+			for(size_t i = 0; i < 70; ++i)
+			{
+				EXPECT(mono::mono_type::get_hash(name) == reference(name));
+				EXPECT(mono::mono_type::get_hash(name.c_str()) == reference(name));
+				name += char('A' + i % 26);
+			}
+			EXPECT(literal_hash == mono::mono_type::get_hash(std::string("Tests.MonoppTest")));
+
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			EXPECT(type.get_hash() == literal_hash);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("read metadata lazily in any order")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto cls = assembly.get_type("Tests", "MonoppTest").get_internal_ptr();
+
+			mono::mono_type first(cls);
+			EXPECT(first.get_fullname() == "Tests.MonoppTest");
+
+			mono::mono_type second(cls);
+			EXPECT(second.get_namespace() == "Tests");
+			EXPECT(second.get_name() == "MonoppTest");
+			EXPECT(second.get_fullname() == first.get_fullname());
+			EXPECT(!second.is_valuetype());
+			EXPECT(!second.is_enum());
+			EXPECT(!second.is_array());
+			EXPECT(second.get_rank() == 0);
+			EXPECT(second.get_hash() == mono::mono_type::get_hash("Tests.MonoppTest"));
+
+			auto method = second.get_method("Function1", 1);
+			EXPECT(method.get_full_declname().find(method.get_fullname()) != std::string::npos);
+			EXPECT(method.get_name() == "Function1");
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("copy wrappers without refcounting")
+	{
+		static_assert(std::is_trivially_copyable<mono::mono_type>::value,
+					  "mono_type should only hold plain pointers");
+		static_assert(std::is_trivially_copyable<mono::mono_object>::value,
+					  "mono_object should only hold plain pointers");
+
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto type = assembly.get_type("Tests", "MonoppTest");
+			auto obj = type.new_instance();
+
+			auto copy = obj;
+			EXPECT(copy.get_type().get_fullname() == type.get_fullname());
+			EXPECT(mono::mono_type(type.get_internal_ptr()).get_hash() == type.get_hash());
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
+	TEST_CASE("build metadata from many threads")
+	{
+		auto expression = [&]()
+		{
+			auto assembly = domain.get_assembly(DATA_DIR "tests_managed.dll");
+			auto cls = assembly.get_type("Tests", "MonoppTest").get_internal_ptr();
+
+			// start cold so that the threads race on inserts as well as lookups
+			mono::reset_type_cache();
+			mono::reset_method_cache();
+			mono::reset_field_cache();
+			mono::reset_property_cache();
+
+			constexpr size_t thread_count = 8;
+			std::atomic<size_t> mismatches{0};
+			std::vector<std::thread> threads;
+			for(size_t t = 0; t < thread_count; ++t)
+			{
+				threads.emplace_back(
+					[&]()
+					{
+						mono::mono_thread_scope scope;
+						for(size_t i = 0; i < 200; ++i)
+						{
+							mono::mono_type type(cls);
+							if(type.get_fullname() != "Tests.MonoppTest")
+							{
+								mismatches++;
+							}
+							for(const auto& field : type.get_fields())
+							{
+								mismatches += field.get_name().empty() ? 1 : 0;
+							}
+							for(const auto& property : type.get_properties())
+							{
+								mismatches += property.get_name().empty() ? 1 : 0;
+							}
+							for(const auto& method : type.get_methods())
+							{
+								mismatches += method.get_name().empty() ? 1 : 0;
+							}
+						}
+					});
+			}
+			for(auto& thread : threads)
+			{
+				thread.join();
+			}
+			EXPECT(mismatches == 0);
+		};
+		EXPECT_NOTHROWS(expression());
+	};
+
 	TEST_CASE("call member method 1")
 	{
 		auto expression = [&]()
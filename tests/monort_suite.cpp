@@ -119,6 +119,7 @@ void test_suite()
         {
 			auto assembly = domain.get_assembly(DATA_DIR"tests_managed.dll");
 			auto type = assembly.get_type("Tests", "MonortTest");
+			EXPECT(type.valid());
 
 			//std::cout << type.get_fullname() << std::endl;
 //			auto fields = type.get_fields();